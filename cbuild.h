@@ -106,8 +106,17 @@
 #define CBUILD_LOCAL_BUFFER_COUNT (4)
 /// @brief Capacity of local buffers in bytes.
 #define CBUILD_LOCAL_BUFFER_CAPACITY CBUILD_PATH_CAPACITY
+/// @brief Size of per-thread scratch arena blocks in bytes.
+/// @details
+/// Scratch arenas grow by appending blocks as needed,
+/// this is not a hard limit. Sized so a block holds at least
+/// CBUILD_LOCAL_BUFFER_COUNT local buffers.
+#define CBUILD_SCRATCH_BLOCK_SIZE\
+    ((CBUILD_LOCAL_BUFFER_COUNT + 1) * CBUILD_LOCAL_BUFFER_CAPACITY)
 
-/// @brief Maximum number of MT jobs.
+/// @brief Initial capacity of per-thread job deques.
+/// @details
+/// Deques grow as needed so this is not a hard limit on jobs in flight.
 #define CBUILD_MAX_JOBS (32)
 
 /// @brief Minimum number of threads allowed.
@@ -128,6 +137,16 @@
     #endif
 #endif
 
+/// @brief Number of threads reserved for internal service threads
+/// (process pool reapers, async logger writer).
+#define CBUILD_SERVICE_THREAD_COUNT (4)
+
+#if !defined(CBUILD_TRACE_CAPACITY)
+    /// @brief Number of trace events each thread can record.
+    /// @details Define before including header to change capacity.
+    #define CBUILD_TRACE_CAPACITY (4096)
+#endif
+
 #if defined(COMPILER_MSVC)
     /// @brief Cross-compiler macro for declaring a thread local variable.
     #define make_tls( type )\
@@ -211,6 +230,26 @@ typedef struct {
     /// @brief Pointer to start of string buffer.
     const char* cc;
 } String;
+/// @brief Linear (bump) allocator.
+/// @details
+/// Allocations are served from one block and released
+/// all at once with arena_reset().
+typedef struct {
+    /// @brief Pointer to start of arena buffer.
+    u8*   buf;
+    /// @brief Capacity of arena buffer in bytes.
+    usize cap;
+    /// @brief Offset of next allocation.
+    usize at;
+} Arena;
+/// @brief Scope in a per-thread scratch arena.
+/// Created by scratch_begin().
+typedef struct {
+    /// @brief Used internally.
+    void* block;
+    /// @brief Used internally.
+    usize at;
+} ScratchScope;
 /// @brief Logger levels.
 typedef enum {
     /// @brief Info level.
@@ -274,12 +313,51 @@ typedef struct {
     /// @brief Opaque handle.
     void* handle;
 } Semaphore;
+/// @brief Lightweight futex-backed event.
+/// @details
+/// Waiters spin briefly before sleeping in the kernel and
+/// signaling with no waiters never leaves user space.
+typedef struct {
+    /// @brief Generation counter, bumped by every signal.
+    atom state;
+} Event;
+/// @brief Adaptive spin-then-wait mutex.
+/// @details
+/// Spins briefly before parking in the kernel, uncontended
+/// lock/unlock is a single atomic operation.
+typedef struct {
+    /// @brief 0 unlocked, 1 locked, 2 locked with waiters.
+    atom state;
+} SpinMutex;
 /// @brief Cross-platform pipe for reading.
 typedef FD ReadPipe;
 /// @brief Cross-platform pipe for writing.
 typedef FD WritePipe;
 /// @brief Cross-platform generic pipe (reading or writing).
 typedef FD Pipe;
+/// @brief Read-only memory-mapped view of a file.
+typedef struct {
+    /// @brief Read-only view of entire file contents.
+    String view;
+    /// @brief Used internally to unmap view (Windows mapping handle).
+    void* handle;
+} FileMap;
+/// @brief Source/destination pair for file_copy_batch().
+typedef struct {
+    /// @brief Null-terminated destination path.
+    const char* dst;
+    /// @brief Null-terminated source path.
+    const char* src;
+} FileCopy;
+/// @brief Result of file_stat()/file_stat_batch().
+typedef struct {
+    /// @brief Set when path exists. Other fields are zero when it does not.
+    b32    exists;
+    /// @brief Last time modified in POSIX time.
+    time_t time_modify;
+    /// @brief Size of file in bytes.
+    usize  size;
+} FileStat;
 /// @brief Command line arguments for creating a process.
 typedef struct {
     /// @brief Number of arguments.
@@ -293,6 +371,14 @@ typedef struct {
     Darray(char) buf;
     /// @brief Array of strings.
     Darray(const char*) args;
+    /// @brief Cached flattened command line.
+    DString* flat;
+    /// @brief Set when arguments changed since last flatten.
+    b32 flat_dirty;
+    /// @brief Backing storage for response file command.
+    DString* response;
+    /// @brief Response file command arguments (exe, \@path, null).
+    const char* response_args[3];
 } CommandBuilder;
 /// @brief Result of walking a directory.
 typedef struct {
@@ -303,17 +389,235 @@ typedef struct {
     /// @brief String buffer.
     DString* buf;
 } WalkDirectory;
+/// @brief Types of compiled glob ops.
+typedef enum {
+    /// @brief Match a literal run of characters.
+    GLOB_OP_LITERAL,
+    /// @brief Match any single character.
+    GLOB_OP_ANY,
+    /// @brief Match any run of characters, including none.
+    GLOB_OP_STAR,
+} GlobOpType;
+/// @brief Single op of a compiled glob pattern. Used internally.
+typedef struct {
+    /// @brief Type of op.
+    GlobOpType type;
+    /// @brief Offset of literal text in pattern buffer.
+    u32 offset;
+    /// @brief Length of literal text.
+    u32 len;
+} GlobOp;
+/// @brief Glob pattern compiled into a reusable matcher.
+typedef struct {
+    /// @brief Copy of pattern text that ops point into.
+    DString* pattern;
+    /// @brief Dynamic array of compiled ops.
+    Darray(GlobOp) ops;
+    /// @brief Literal suffix when pattern is '*literal', empty otherwise.
+    String suffix;
+} GlobProgram;
+/// @brief Extension bucket in a walk index. Used internally.
+typedef struct {
+    /// @brief Extension, including leading dot.
+    String ext;
+    /// @brief Dynamic array of indices into the walk's paths.
+    Darray(u32) paths;
+} WalkIndexBucket;
+/// @brief Secondary indexes over a path_walk_dir() result.
+typedef struct {
+    /// @brief Walk result the index was built over.
+    const WalkDirectory* wd;
+    /// @brief Dynamic array of per-extension buckets.
+    Darray(WalkIndexBucket) buckets;
+    /// @brief Indices into the walk's paths, sorted lexicographically.
+    Darray(u32) sorted;
+} WalkIndex;
+/// @brief ID of a path interned in a path pool.
+/// @details Zero is never a valid ID.
+typedef u32 PathID;
+/// @brief Interned path entry. Used internally.
+typedef struct {
+    /// @brief ID of parent directory, or 0 for none.
+    PathID parent;
+    /// @brief Offset of name component in pool's character buffer.
+    u32 name_offset;
+    /// @brief Length of name component.
+    u32 name_len;
+    /// @brief Length of full path.
+    u32 len;
+} PathPoolEntry;
+/// @brief Interning pool of paths with parent-directory prefix sharing.
+typedef struct {
+    /// @brief Character buffer holding unique name components.
+    DString* buf;
+    /// @brief Dynamic array of entries. ID is index + 1.
+    Darray(PathPoolEntry) entries;
+    /// @brief Used internally.
+    u32* table;
+    /// @brief Used internally.
+    u32 table_cap;
+} PathPool;
+/// @brief Function prototype for watch mode callbacks.
+/// @param[in] changed Dynamic array of changed paths.
+/// Invalid after callback returns.
+/// @param[in] params  (optional) Pointer to additional parameters.
+/// @return
+///     - @c True  : Keep watching.
+///     - @c False : Stop watching and return from path_watch().
+typedef b32 WatchFN( const Darray(String) changed, void* params );
+/// @brief Input file record in a build cache entry.
+typedef struct {
+    /// @brief Path of input file.
+    DString* path;
+    /// @brief Last time modified when this input was recorded.
+    time_t   time_modify;
+    /// @brief Content hash of input when it was recorded.
+    u64      hash;
+} BuildCacheInput;
+/// @brief Recorded state of a single build target.
+typedef struct {
+    /// @brief Path of target output file.
+    DString* target;
+    /// @brief Hash of target's flattened command.
+    u64      cmd_hash;
+    /// @brief Dynamic array of input records.
+    Darray(BuildCacheInput) inputs;
+} BuildCacheEntry;
+/// @brief Build cache with an on-disk manifest.
+typedef struct {
+    /// @brief Path of manifest file.
+    DString* path;
+    /// @brief Dynamic array of target entries.
+    Darray(BuildCacheEntry) entries;
+} BuildCache;
+/// @brief File record in a dependency index.
+typedef struct {
+    /// @brief Path of file.
+    DString* path;
+    /// @brief Last time modified when file was scanned.
+    time_t   time_modify;
+    /// @brief Dynamic array of indices of entries this file includes.
+    Darray(u32) includes;
+    /// @brief Used internally to avoid rescanning entries.
+    u32 mark;
+} DepIndexEntry;
+/// @brief C/C++ header dependency index with an on-disk cache.
+typedef struct {
+    /// @brief Path of index file.
+    DString* path;
+    /// @brief Dynamic array of include directories.
+    Darray(DString*) include_dirs;
+    /// @brief Dynamic array of file entries.
+    Darray(DepIndexEntry) entries;
+    /// @brief Used internally to avoid rescanning entries.
+    u32 mark;
+} DepIndex;
+/// @brief Local compiler cache backed by a directory of objects.
+typedef struct {
+    /// @brief Path of cache directory.
+    DString* dir;
+    /// @brief Number of cache hits since cache was opened.
+    atom hits;
+    /// @brief Number of cache misses since cache was opened.
+    atom misses;
+} CompilerCache;
+/// @brief Function prototype for process pool completion callbacks.
+/// @param[in] cmd    Command that completed.
+/// @param     res    Return code, same convention as process_wait().
+/// @param[in] params (optional) Pointer to additional parameters.
+typedef void ProcessPoolFN( const Command* cmd, int res, void* params );
+/// @brief Entry in a process pool. Used internally.
+typedef struct {
+    /// @brief Command to execute.
+    Command        cmd;
+    /// @brief (optional) Function to call when command completes.
+    ProcessPoolFN* callback;
+    /// @brief (optional) Pointer to additional parameters for callback.
+    void*          params;
+    /// @brief ID of process while command is executing.
+    PID            pid;
+} ProcessPoolEntry;
+/// @brief Pool that executes commands with bounded parallelism.
+typedef struct {
+    /// @brief Maximum number of commands that execute concurrently.
+    u32 max_parallel;
+    /// @brief Used internally to protect queued entries.
+    Mutex lock;
+    /// @brief Used internally to wake reaper thread.
+    Semaphore wakeup;
+    /// @brief Used internally. Entries waiting to be executed.
+    Darray(ProcessPoolEntry) queued;
+    /// @brief Used internally. Entries currently executing.
+    /// Only touched by reaper thread.
+    Darray(ProcessPoolEntry) running;
+    /// @brief Used internally. Number of entries not yet completed.
+    atom pending;
+    /// @brief Used internally. Signals reaper thread to exit.
+    atom shutdown;
+    /// @brief Used internally. Set by reaper thread when it exits.
+    atom stopped;
+} ProcessPool;
+/// @brief Function prototype for pipe capture completion callbacks.
+/// @param[in] output Everything the pipe produced.
+/// Invalid after callback returns.
+/// @param[in] params (optional) Pointer to additional parameters.
+typedef void PipeCaptureFN( String output, void* params );
+/// @brief Pipe registered with a capture engine. Used internally.
+typedef struct {
+    /// @brief Pipe being drained.
+    ReadPipe pipe;
+    /// @brief Function to call when pipe closes.
+    PipeCaptureFN* callback;
+    /// @brief Additional parameters for callback.
+    void* params;
+    /// @brief Captured output so far.
+    DString* buf;
+} PipeCaptureEntry;
+/// @brief Event-driven capture engine for child process pipes.
+typedef struct {
+    /// @brief Used internally to protect submitted entries.
+    Mutex lock;
+    /// @brief Used internally. Entries waiting to be picked up.
+    Darray(PipeCaptureEntry) submitted;
+    /// @brief Used internally to interrupt the capture thread's wait.
+    ReadPipe wake_read;
+    /// @brief Used internally to interrupt the capture thread's wait.
+    WritePipe wake_write;
+    /// @brief Used internally. Number of pipes not yet closed.
+    atom pending;
+    /// @brief Used internally. Signals capture thread to exit.
+    atom shutdown;
+    /// @brief Used internally. Set by capture thread when it exits.
+    atom stopped;
+} PipeCapture;
 /// @brief Hang thread on wait.
 #define MT_WAIT_INFINITE (UINT32_MAX)
 /// @brief Function prototype for job system.
 /// @param[in] params (optional) Pointer to additional parameters.
 typedef void JobFN( void* params );
+/// @brief ID of a job in the job graph.
+typedef u32 JobID;
+/// @brief Create a null job graph ID.
+/// @return Null job graph ID.
+#define job_id_null() (0)
 /// @brief Filter prototype for string split functions.
 /// @param     index  Index of the string being filtered.
 /// @param     str    String to be filtered.
 /// @param[in] params (optional) Pointer to additional parameters.
 /// @return Filtered string.
 typedef String StringSplitDelimFilterFN( usize index, String str, void* params );
+/// @brief Cursor for splitting a string without allocating.
+/// Create with string_split_iter(), advance with string_split_next().
+typedef struct {
+    /// @brief Used internally. Remaining string to split.
+    String rem;
+    /// @brief Used internally. Delimiter to split by.
+    String delim;
+    /// @brief Used internally. True if delimiter is kept in splits.
+    b32    keep_delim;
+    /// @brief Used internally. True when iteration has finished.
+    b32    done;
+} StringSplitIter;
 /// @brief Filter prototype for dynamic array.
 /// @param     index       Index of item being tested.
 /// @param     item_stride Size of items in array.
@@ -324,6 +628,19 @@ typedef String StringSplitDelimFilterFN( usize index, String str, void* params )
 ///     - @c False : Item failed filter, will be filtered out.
 typedef b32 DarrayFilterFN(
     usize index, usize item_stride, const void* item, void* params );
+/// @brief Map prototype for dynamic array. Transforms items in-place.
+/// @param        index       Index of item being mapped.
+/// @param        item_stride Size of items in array.
+/// @param[in,out] item       Pointer to item being mapped.
+/// @param[in]    params      (optional) Pointer to additional parameters.
+typedef void DarrayMapFN(
+    usize index, usize item_stride, void* item, void* params );
+/// @brief Comparison prototype for dynamic array sorting.
+/// Same contract as qsort() comparators.
+/// @param[in] lhs Pointer to left hand item.
+/// @param[in] rhs Pointer to right hand item.
+/// @return Negative if lhs sorts before rhs, positive if after, zero if equal.
+typedef int DarraySortCmpFN( const void* lhs, const void* rhs );
 
 static inline void _0( int _, ... ) {(void)_;}
 /// @brief Mark any variables/parameters as unused.
@@ -410,6 +727,28 @@ does_not_return() void cbuild_rebuild(
     const char* cbuild_source_file_name,
     const char* cbuild_executable_name, b32 reload );
 
+/// @brief Subsystem tags for heap allocation tracking.
+typedef enum {
+    /// @brief Untagged allocations.
+    MEMORY_TAG_GENERAL,
+    /// @brief Dynamic array storage.
+    MEMORY_TAG_DARRAY,
+    /// @brief Dynamic string storage.
+    MEMORY_TAG_DSTRING,
+    /// @brief Per-thread scratch arenas.
+    MEMORY_TAG_SCRATCH,
+    /// @brief Job queue and job buffers.
+    MEMORY_TAG_JOB,
+    /// @brief Directory walk results.
+    MEMORY_TAG_WALK,
+    /// @brief Process pools and captured process output.
+    MEMORY_TAG_PROCESS,
+    /// @brief Build/compiler caches and dependency indexes.
+    MEMORY_TAG_CACHE,
+    /// @brief Number of memory tags.
+    MEMORY_TAG_COUNT
+} MemoryTag;
+
 /// @brief Allocate memory on the heap. Always returns zeroed memory.
 /// @warning
 /// Do not free with free(), use memory_free() instead!
@@ -443,6 +782,62 @@ usize memory_query_usage(void);
 /// @brief Query how many bytes have been allocated thus far.
 /// @return Bytes allocated in total.
 usize memory_query_total_usage(void);
+/// @brief Query the most bytes that were ever allocated at once.
+/// @return High-water mark in bytes.
+usize memory_query_peak_usage(void);
+/// @brief Set the calling thread's allocation tag.
+/// @details
+/// Heap allocations are attributed to the calling thread's current
+/// tag. Restore the previous tag when the tagged phase ends. Frees
+/// are attributed to the current tag as well, so mismatched scopes
+/// skew per-tag counters; the global counters are always exact.
+/// @param tag Tag to attribute allocations to.
+/// @return Previously set tag.
+MemoryTag memory_tag_set( MemoryTag tag );
+/// @brief Get display name of memory tag.
+/// @param tag Tag to get name of.
+/// @return Static null-terminated tag name.
+const char* memory_tag_name( MemoryTag tag );
+/// @brief Query how many bytes are currently allocated under tag.
+/// @param tag Tag to query.
+/// @return Bytes allocated.
+usize memory_query_tag_usage( MemoryTag tag );
+/// @brief Query the most bytes ever allocated at once under tag.
+/// @param tag Tag to query.
+/// @return High-water mark in bytes.
+usize memory_query_tag_peak( MemoryTag tag );
+/// @brief Log a per-tag usage/leak report when the process exits.
+/// @details
+/// Reports current and peak usage for every tag and warns about
+/// bytes still allocated at exit. Long-lived subsystems (job queue,
+/// scratch arenas) are intentionally never freed and show up there.
+void memory_enable_usage_report(void);
+/// @brief Create an arena with given capacity.
+/// @details
+/// Arena capacity is fixed, allocations fail once it's exhausted.
+/// @param      cap       Capacity of arena in bytes.
+/// @param[out] out_arena Pointer to write arena to.
+/// @return
+///     - @c True  : Arena was created.
+///     - @c False : Failed to allocate arena buffer.
+b32 arena_create( usize cap, Arena* out_arena );
+/// @brief Allocate memory from an arena. Always returns zeroed memory.
+/// @warning
+/// Do not free result, it's released by arena_reset()/arena_destroy().
+/// @param[in] arena Arena to allocate from.
+/// @param     size  Size in bytes of allocation.
+/// @return
+///     - Pointer : Allocation succeeded, pointer to start of buffer.
+///     - NULL    : Arena does not have enough space left.
+void* arena_alloc( Arena* arena, usize size );
+/// @brief Release every allocation made from an arena at once.
+/// @details
+/// Arena buffer is zeroed and reused, no memory is returned to the heap.
+/// @param[in] arena Arena to reset.
+void arena_reset( Arena* arena );
+/// @brief Free an arena and its buffer.
+/// @param[in] arena Arena to destroy.
+void arena_destroy( Arena* arena );
 /// @brief Copy value across block of memory.
 /// @param[in] memory     Block to modify, must be >= @c value_size in size.
 /// @param     value_size Size of value to stamp.
@@ -664,6 +1059,34 @@ void string_split_at(
 b32 string_split_char(
     String src, char c, b32 keep_split,
     String* opt_out_left, String* opt_out_right );
+/// @brief Create an iterator that splits string by delimiter.
+/// @details
+/// Iteration yields views into @c src and never allocates; use it
+/// instead of string_split_delim() when the splits do not need to
+/// outlive @c src or be indexed.
+/// @param src        String to split.
+/// @param delim      Delimiter to split by. Must not be empty.
+/// @param keep_delim True if delimiter should be kept in splits.
+/// @return Iterator to pass to string_split_next().
+StringSplitIter string_split_iter( String src, String delim, b32 keep_delim );
+/// @brief Create an iterator that splits string by delimiter character.
+/// @param src        String to split.
+/// @param delim      Delimiter character to split by.
+/// @param keep_delim True if delimiter should be kept in splits.
+/// @return Iterator to pass to string_split_next().
+#define string_split_iter_char( src, delim, keep_delim )\
+    string_split_iter( src, string_new( 1, (char[]){ delim } ), keep_delim )
+/// @brief Get next split from a split iterator.
+/// @details
+/// Yields the same splits in the same order as string_split_delim()
+/// with the same arguments, including empty splits between
+/// consecutive delimiters.
+/// @param[in]  iter      Iterator created by string_split_iter().
+/// @param[out] out_split Pointer to write split to.
+/// @return
+///     - @c True  : Split was written to @c out_split.
+///     - @c False : Iteration has finished, @c out_split is untouched.
+b32 string_split_next( StringSplitIter* iter, String* out_split );
 /// @brief Split string by delimiter. Allocates dynamic array.
 /// @param src        String to split.
 /// @param delim      Delimiter to split by.
@@ -729,6 +1152,26 @@ DString* dstring_empty( usize cap );
 ///     - @c Dynamic String : Buffer was successfully allocated.
 ///     - @c NULL : Failed to allocate dynamic string.
 DString* dstring_new( usize len, const char* str );
+/// @brief Allocate an empty dynamic string from an arena.
+/// @details
+/// String grows from the arena and dstring_free() is a no-op for it,
+/// its memory is released by arena_reset().
+/// @param[in] opt_arena (optional) Arena to allocate from, heap if null.
+/// @param     cap       Capacity to allocate.
+/// @return
+///     - @c Dynamic String : Buffer was successfully allocated.
+///     - @c NULL : Failed to allocate dynamic string.
+DString* dstring_empty_arena( Arena* opt_arena, usize cap );
+/// @brief Create a new dynamic string from string buffer, from an arena.
+/// @details
+/// Same arena semantics as dstring_empty_arena().
+/// @param[in] opt_arena (optional) Arena to allocate from, heap if null.
+/// @param     len       Length of string buffer.
+/// @param[in] str       Pointer to start of string buffer.
+/// @return
+///     - @c Dynamic String : Buffer was successfully allocated.
+///     - @c NULL : Failed to allocate dynamic string.
+DString* dstring_new_arena( Arena* opt_arena, usize len, const char* str );
 /// @brief Create a new dynamic string from null-terminated string.
 /// @details
 /// Allocates appropriately sized dynamic string and
@@ -1033,6 +1476,17 @@ void* darray_empty( usize stride, usize cap );
 ///     - @c Pointer : Pointer to start of dynamic array.
 ///     - @c NULL    : Failed to allocate dynamic array.
 void* darray_from_array( usize stride, usize len, const void* buf );
+/// @brief Allocate an empty dynamic array from an arena.
+/// @details
+/// Array grows from the arena and darray_free() is a no-op for it,
+/// its memory is released by arena_reset().
+/// @param[in] opt_arena (optional) Arena to allocate from, heap if null.
+/// @param     stride    Size of items in dynamic array.
+/// @param     cap       Number of items dynamic array should be able to hold.
+/// @return
+///     - @c Pointer : Pointer to start of dynamic array.
+///     - @c NULL    : Failed to allocate dynamic array.
+void* darray_empty_arena( Arena* opt_arena, usize stride, usize cap );
 /// @brief Calculate memory requirement for dynamic array.
 /// @details
 /// Used to create dynamic array with fixed memory size.
@@ -1084,6 +1538,68 @@ void* darray_join( usize stride,
 void* darray_from_filter(
     usize stride, usize len, const void* src,
     DarrayFilterFN* filter, void* filter_params );
+/// @brief Create dynamic array from filtered array,
+/// running the filter across the job queue.
+/// @details
+/// Partitions @c src across worker threads, evaluates @c filter
+/// in parallel and copies survivors in order on the calling thread,
+/// so results are identical to darray_from_filter().
+/// @c filter must be safe to call concurrently from multiple threads.
+/// Falls back to serial filtering for small arrays.
+/// @param     stride        Size of items in @c src.
+/// @param     len           Length of @c src.
+/// @param[in] src           Pointer to start of array to be filtered.
+/// @param[in] filter        Pointer to filter function.
+/// @param[in] filter_params (optional) Parameters to filter function.
+/// @return
+///     - @c Pointer : Pointer to start of dynamic array.
+///     - @c NULL    : Failed to allocate dynamic array.
+void* darray_from_filter_parallel(
+    usize stride, usize len, const void* src,
+    DarrayFilterFN* filter, void* filter_params );
+/// @brief Filter array into a caller-provided index list. Does not allocate.
+/// @details
+/// Items are never copied; indices of items that pass @c filter are
+/// written to @c out_indices in order. @c out_indices must be able
+/// to hold @c len indices.
+/// @param      stride        Size of items in @c src.
+/// @param      len           Length of @c src.
+/// @param[in]  src           Pointer to start of array to be filtered.
+/// @param[in]  filter        Pointer to filter function.
+/// @param[in]  filter_params (optional) Parameters to filter function.
+/// @param[out] out_indices   Buffer that receives indices of surviving items.
+/// @return Number of indices written.
+usize darray_filter_indices(
+    usize stride, usize len, const void* src,
+    DarrayFilterFN* filter, void* filter_params, u32* out_indices );
+/// @brief Apply @c map to every item of dynamic array in-place.
+/// @param[in] darray     Dynamic array to map.
+/// @param[in] map        Pointer to map function.
+/// @param[in] map_params (optional) Parameters to map function.
+void darray_map( void* darray, DarrayMapFN* map, void* map_params );
+/// @brief Apply @c map to every item of dynamic array in-place,
+/// partitioned across the job queue.
+/// @details
+/// @c map must be safe to call concurrently from multiple threads
+/// and must not touch items outside the one it was handed.
+/// Falls back to serial mapping for small arrays.
+/// @param[in] darray     Dynamic array to map.
+/// @param[in] map        Pointer to map function.
+/// @param[in] map_params (optional) Parameters to map function.
+void darray_map_parallel( void* darray, DarrayMapFN* map, void* map_params );
+/// @brief Sort dynamic array.
+/// @param[in] darray Dynamic array to sort.
+/// @param[in] cmp    Pointer to comparison function.
+void darray_sort( void* darray, DarraySortCmpFN* cmp );
+/// @brief Sort dynamic array, distributing work across the job queue.
+/// @details
+/// Sorts partitions on worker threads and merges them on the calling
+/// thread. Not a stable sort. @c cmp must be safe to call concurrently.
+/// Falls back to darray_sort() for small arrays or if the merge
+/// buffer can't be allocated.
+/// @param[in] darray Dynamic array to sort.
+/// @param[in] cmp    Pointer to comparison function.
+void darray_sort_parallel( void* darray, DarraySortCmpFN* cmp );
 /// @brief Grow dynamic array by @c amount number of items.
 /// @param[in] darray Dynamic array to grow.
 /// @param     amount Number of items to grow by.
@@ -1315,6 +1831,27 @@ String* path_chunk_split( String path );
 ///     - @c True  : @c path matches @c glob.
 ///     - @c False : @c path does not match @c glob.
 b32 path_matches_glob( String path, String glob );
+/// @brief Compile a glob pattern into a reusable matcher.
+/// @details
+/// Compile once, then glob_match() many paths against it with a tight
+/// non-recursive loop. Patterns of the shape @c *literal (e.g. @c *.c)
+/// are matched with a plain suffix comparison.
+/// @param      glob        Glob pattern to compile.
+/// @param[out] out_program Pointer to write program to.
+/// @return
+///     - @c True  : Pattern was compiled.
+///     - @c False : Failed to allocate program.
+b32 glob_compile( String glob, GlobProgram* out_program );
+/// @brief Match a path against a compiled glob pattern.
+/// @param[in] program Compiled glob pattern.
+/// @param     path    Path to match.
+/// @return
+///     - @c True  : @c path matches pattern.
+///     - @c False : @c path does not match pattern.
+b32 glob_match( const GlobProgram* program, String path );
+/// @brief Free a compiled glob pattern.
+/// @param[in] program Program to free.
+void glob_free( GlobProgram* program );
 /// @brief Walk a directory, collecting all files/directories.
 /// @details
 /// If @c out_result is empty, allocates new buffers for it.
@@ -1330,6 +1867,23 @@ b32 path_matches_glob( String path, String glob );
 b32 path_walk_dir(
     const char* dir, b32 recursive,
     b32 include_dirs, WalkDirectory* out_result );
+/// @brief Walk a directory in parallel, collecting all files/directories.
+/// @details
+/// Walk is always recursive, subdirectories are fanned out
+/// as jobs on the job queue so order of paths in @c out_result
+/// is unspecified.
+///
+/// If @c out_result is empty, allocates new buffers for it.
+/// Otherwise, appends results to end of @c out_result.
+/// @param[in]      dir          Path to directory to walk.
+/// @param          include_dirs If function should include directory names in final list.
+/// @param[in, out] out_result   Result of directory walk.
+/// @return
+///     - @c True  : Successfully walked directory and wrote results to @c out_result.
+///     - @c False : Failed to open @c dir or any of its subdirectories.
+///     - @c False : Failed to allocate results.
+b32 path_walk_dir_parallel(
+    const char* dir, b32 include_dirs, WalkDirectory* out_result );
 /// @brief Create list of filtered paths from path_walk_dir() result.
 /// @param[in] wd   path_walk_dir() result to filter.
 /// @param     glob Glob pattern to check for.
@@ -1337,9 +1891,173 @@ b32 path_walk_dir(
 ///     - Dynamic array of paths that match pattern.
 ///     - NULL : Failed to allocate result.
 Darray(String) path_walk_glob_filter( const WalkDirectory* wd, String glob );
+/// @brief Create a filtered array from path_walk_dir() result
+/// using a compiled glob pattern.
+/// @details
+/// Use instead of path_walk_glob_filter() when the same
+/// pattern is applied to many walk results.
+/// @param[in] wd      Walk directory result.
+/// @param[in] program Compiled glob pattern to check for.
+/// @return
+///     - Dynamic array of paths that match pattern.
+///     - NULL : Failed to allocate result.
+Darray(String) path_walk_glob_filter_compiled(
+    const WalkDirectory* wd, const GlobProgram* program );
 /// @brief Free result of path_walk_dir().
 /// @param[in] wd Walk directory result to free.
 void path_walk_free( WalkDirectory* wd );
+/// @brief Save a path_walk_dir() result to a binary snapshot file.
+/// @details
+/// Records the modification time of every directory containing a
+/// walked path so path_walk_load() can cheaply detect a stale
+/// snapshot without re-walking the tree.
+/// @param[in] path Null-terminated path to write snapshot to.
+/// @param[in] wd   Walk result to save.
+/// @return
+///     - @c True  : Snapshot was written.
+///     - @c False : Failed to write snapshot.
+b32 path_walk_save( const char* path, const WalkDirectory* wd );
+/// @brief Load a path_walk_dir() result from a binary snapshot file.
+/// @details
+/// Re-stats only the directories recorded in the snapshot. If any
+/// directory changed since the snapshot was saved (files added,
+/// removed or renamed), the snapshot is rejected and the caller
+/// should re-walk and save a fresh one. Editing a file's contents
+/// does not change its directory's mtime and does not invalidate
+/// the snapshot. Paths are appended to @c out_result the same way
+/// path_walk_dir() appends them.
+/// @param[in]  path       Null-terminated path to read snapshot from.
+/// @param[out] out_result Pointer to walk result to append paths to.
+/// @return
+///     - @c True  : Snapshot was valid and loaded.
+///     - @c False : Snapshot is missing, corrupt or out of date.
+b32 path_walk_load( const char* path, WalkDirectory* out_result );
+
+/// @brief Build secondary indexes over a walk result.
+/// @details
+/// Builds a bucket of paths per file extension and a lexicographically
+/// sorted index so directory queries become range scans. @c wd must
+/// outlive the index and must not be appended to while the index is
+/// in use.
+/// @param[in]  wd        Walk result to index.
+/// @param[out] out_index Pointer to write index to.
+/// @return
+///     - @c True  : Index was built.
+///     - @c False : Failed to allocate index.
+b32 path_walk_index_build( const WalkDirectory* wd, WalkIndex* out_index );
+/// @brief Create list of filtered paths using a walk index.
+/// @details
+/// Same matches as path_walk_glob_filter() on the indexed walk, but
+/// patterns like "*.c" become an extension bucket lookup and patterns
+/// with a literal directory like "src/*.c" only scan that directory's
+/// span of the sorted index. Anything else falls back to a full scan.
+/// Order of results may differ from path_walk_glob_filter().
+/// @param[in] index Index to query.
+/// @param     glob  Glob pattern to check for.
+/// @return
+///     - Dynamic array of paths that match pattern.
+///     - NULL : Failed to allocate result.
+Darray(String) path_walk_index_glob_filter(
+    const WalkIndex* index, String glob );
+/// @brief Get the span of indexed paths inside a directory.
+/// @details
+/// Span is a range in the index's sorted array, iterate with
+/// index->wd->paths[index->sorted[i]]. Covers subdirectories.
+/// @param[in]  index    Index to query.
+/// @param      dir      Directory path, with or without trailing separator.
+/// @param[out] out_from Pointer to write first index of span to.
+/// @param[out] out_to   Pointer to write one-past-last index of span to.
+/// @return
+///     - @c True  : Directory has indexed paths, span was written.
+///     - @c False : No indexed paths are inside @c dir.
+b32 path_walk_index_dir(
+    const WalkIndex* index, String dir, usize* out_from, usize* out_to );
+/// @brief Free a walk index. Does not free the indexed walk result.
+/// @param[in] index Index to free.
+void path_walk_index_free( WalkIndex* index );
+
+/// @brief Create an empty path pool.
+/// @details
+/// Each unique path is stored once, one name component per entry
+/// with parent directories shared between paths, and callers
+/// traffic in 32-bit IDs. Two paths are equal exactly when their
+/// IDs are equal.
+/// @param[out] out_pool Pointer to write pool to.
+/// @return
+///     - @c True  : Pool was created.
+///     - @c False : Failed to allocate pool.
+b32 path_pool_create( PathPool* out_pool );
+/// @brief Intern a path, returning its ID.
+/// @details
+/// Repeated separators and a trailing separator are ignored,
+/// no other normalization is applied so "./a" and "a" intern
+/// to different IDs.
+/// @param[in] pool Pool to intern into.
+/// @param     path Path to intern.
+/// @return ID of path, or 0 if @c path is empty or allocation failed.
+PathID path_pool_intern( PathPool* pool, String path );
+/// @brief Reconstruct the full path of an interned ID.
+/// @details
+/// Path is written to a local buffer,
+/// same rules as scratch_alloc().
+/// @param[in] pool Pool that @c id was interned in.
+/// @param     id   ID of path.
+/// @return Full path.
+String path_pool_get( const PathPool* pool, PathID id );
+/// @brief Intern every path of a walk result.
+/// @param[in] pool Pool to intern into.
+/// @param[in] wd   path_walk_dir() result to intern.
+/// @return
+///     - Dynamic array of IDs, in the same order as @c wd->paths.
+///     - NULL : Failed to allocate result.
+Darray(PathID) path_pool_intern_walk( PathPool* pool, const WalkDirectory* wd );
+/// @brief Create list of interned paths that match a glob pattern.
+/// @param[in] pool  Pool that @c paths were interned in.
+/// @param[in] paths Dynamic array of IDs to filter.
+/// @param     glob  Glob pattern to check for.
+/// @return
+///     - Dynamic array of IDs that match pattern.
+///     - NULL : Failed to allocate result.
+Darray(PathID) path_pool_glob_filter(
+    const PathPool* pool, const Darray(PathID) paths, String glob );
+/// @brief Create list of interned paths that match a compiled glob.
+/// @details
+/// Use instead of path_pool_glob_filter() when the same
+/// pattern is applied to many lists.
+/// @param[in] pool    Pool that @c paths were interned in.
+/// @param[in] paths   Dynamic array of IDs to filter.
+/// @param[in] program Compiled glob pattern to check for.
+/// @return
+///     - Dynamic array of IDs that match pattern.
+///     - NULL : Failed to allocate result.
+Darray(PathID) path_pool_glob_filter_compiled(
+    const PathPool* pool, const Darray(PathID) paths,
+    const GlobProgram* program );
+/// @brief Free a path pool.
+/// @warning IDs interned in the pool are invalid after this.
+/// @param[in] pool Pool to free.
+void path_pool_free( PathPool* pool );
+
+/// @brief Watch a tree for changes and re-run a callback. Blocks.
+/// @details
+/// Subscribes to OS file-change notifications (inotify on Linux,
+/// ReadDirectoryChangesW on Windows, stat polling elsewhere) for
+/// @c dir and every directory of @c wd, then runs @c callback with
+/// the list of changed paths whenever something changes. Bursts of
+/// writes are batched through a short settle window. Returns once
+/// @c callback returns false.
+/// @param[in] dir        Root directory to watch. Length must be <= 4096.
+/// @param[in] wd         Walk of @c dir, used to subscribe to its
+/// subdirectories. Walk with include_dirs or changes in
+/// subdirectories are missed.
+/// @param[in] callback   Function to call with changed paths.
+/// @param[in] opt_params (optional) Pointer to additional parameters for callback.
+/// @return
+///     - @c True  : Watched until callback returned false.
+///     - @c False : Failed to subscribe to change notifications.
+b32 path_watch(
+    const char* dir, const WalkDirectory* wd,
+    WatchFN* callback, void* opt_params );
 
 /// @brief Create a null file descriptor.
 /// @return Null file descriptor.
@@ -1364,6 +2082,18 @@ void fd_close( FD* file );
 ///     - @c True  : Successfully wrote to file.
 ///     - @c False : Failed to write file.
 b32 fd_write( FD* file, usize size, const void* buf, usize* opt_out_write_size );
+/// @brief Write multiple buffers to file.
+/// @details
+/// Gathers @c parts into vectored writes (writev) so composing a file
+/// or log line from many pieces does not cost one syscall per piece.
+/// Parts are written in order with nothing in between.
+/// @param[in] file  File descriptor to write to.
+/// @param     count Number of parts to write.
+/// @param[in] parts Pointer to list of parts to write.
+/// @return
+///     - @c True  : Successfully wrote every part.
+///     - @c False : Failed to write file.
+b32 fd_write_many( FD* file, usize count, const String* parts );
 /// @brief Write formatted string to file.
 /// @param[in] file   File descriptor to write to.
 /// @param[in] format Format string literal.
@@ -1408,6 +2138,31 @@ void fd_seek( FD* file, FileSeek type, isize seek );
 /// @param[in] file File descriptor.
 /// @return Bytes from start of file.
 usize fd_query_position( FD* file );
+/// @brief Map an open file into memory as a read-only view.
+/// @details
+/// Zero-copy alternative to fd_read() for whole-file access, no
+/// buffer is allocated. @c file must be open for reading and stays
+/// open, the view remains valid after closing it. View of an empty
+/// file has length zero. Unmap with file_unmap().
+/// @param[in]  file    File descriptor to map.
+/// @param[out] out_map Pointer to write map to.
+/// @return
+///     - @c True  : File was mapped.
+///     - @c False : Failed to map file.
+b32 fd_map( FD* file, FileMap* out_map );
+/// @brief Open file at given path and map it into memory.
+/// @details
+/// Convenience over fd_open() + fd_map(), no descriptor
+/// stays open. Unmap with file_unmap().
+/// @param[in]  path    Null-terminated path to file. Length must be <= 4096.
+/// @param[out] out_map Pointer to write map to.
+/// @return
+///     - @c True  : File was mapped.
+///     - @c False : Failed to open or map file.
+b32 file_map( const char* path, FileMap* out_map );
+/// @brief Unmap a memory-mapped file view.
+/// @param[in] map Map to unmap.
+void file_unmap( FileMap* map );
 /// @brief Query creation time of file at given path.
 /// @param[in] path Null-terminated path to file. Length must be <= 4096.
 /// @return Creation time in POSIX time.
@@ -1416,6 +2171,29 @@ time_t file_query_time_create( const char* path );
 /// @param[in] path Null-terminated path to file. Length must be <= 4096.
 /// @return Last time modified in POSIX time.
 time_t file_query_time_modify( const char* path );
+/// @brief Query existence, last time modified and size of file at given path.
+/// @details
+/// Unlike file_query_time_modify(), a missing file is a valid result
+/// rather than a fatal error, so this is safe to call on build outputs
+/// that haven't been generated yet.
+/// @param[in]  path     Null-terminated path to file. Length must be <= 4096.
+/// @param[out] out_stat Pointer to write result to.
+/// @return
+///     - @c True  : File exists, @c out_stat holds its times and size.
+///     - @c False : File does not exist, @c out_stat is zeroed.
+b32 file_stat( const char* path, FileStat* out_stat );
+/// @brief Query existence, last time modified and size of a list of files.
+/// @details
+/// Distributes queries across the job queue and blocks until every
+/// path was checked. Paths that share a parent directory resolve
+/// through a cached directory handle so the directory components are
+/// only traversed once per batch rather than once per path, which
+/// matters on network file systems. Missing files are reported with
+/// @c exists set to false, they are not an error.
+/// @param      count     Number of paths to check.
+/// @param[in]  paths     Pointer to list of null-terminated paths.
+/// @param[out] out_stats Pointer to list to write results to.
+void file_stat_batch( usize count, const char** paths, FileStat* out_stats );
 /// @brief Move file from one path to another.
 /// @param[in] dst Null-terminated destination path. Length must be <= 4096.
 /// @param[in] src Null-terminated source path. Length must be <= 4096.
@@ -1430,6 +2208,17 @@ b32 file_move( const char* dst, const char* src );
 ///     - @c True  : Successfully copied file.
 ///     - @c False : Failed to copie file.
 b32 file_copy( const char* dst, const char* src );
+/// @brief Copy a list of files in parallel.
+/// @details
+/// Distributes copies across the job queue and blocks until every
+/// copy finished. Copying is pure I/O so this runs at disk speed
+/// once there are enough pairs to keep the workers busy.
+/// @param     count  Number of pairs to copy.
+/// @param[in] copies Pointer to list of source/destination pairs.
+/// @return
+///     - @c True  : Copied every file successfully.
+///     - @c False : One or more copies failed.
+b32 file_copy_batch( usize count, const FileCopy* copies );
 /// @brief Remove file from system.
 /// @param[in] path Null-terminated path. Length must be <= 4096.
 /// @return
@@ -1555,24 +2344,93 @@ void semaphore_signal( Semaphore* semaphore );
 /// @brief Destroy a semaphore.
 /// @param[in] semaphore Semaphore to destroy.
 void semaphore_destroy( Semaphore* semaphore );
+
+/// @brief Create a lightweight event.
+/// @param[out] out_event Pointer to write event to.
+/// @return
+///     - @c True : Created event successfully.
+b32 event_create( Event* out_event );
+/// @brief Get current generation of event.
+/// @details
+/// Obtain the generation before rechecking the waited-on condition,
+/// then pass it to event_wait(). A signal between the recheck and
+/// the wait bumps the generation so the wait returns immediately.
+/// @param[in] event Event to get generation of.
+/// @return Current generation.
+atom event_prepare( Event* event );
+/// @brief Wait until event is signaled.
+/// @details
+/// Returns as soon as the event was signaled after @c generation was
+/// obtained with event_prepare(). Spins briefly before sleeping so
+/// sub-millisecond signals never enter the kernel.
+/// @param[in] event      Event to wait for.
+/// @param     generation Generation from event_prepare().
+void event_wait( Event* event, atom generation );
+/// @brief Wait until event is signaled, with timeout.
+/// @param[in] event      Event to wait for.
+/// @param     generation Generation from event_prepare().
+/// @param     ms         Maximum milliseconds to wait for signal.
+/// @return
+///     - @c True  : Event was signaled in time.
+///     - @c False : Timed out.
+b32 event_wait_timed( Event* event, atom generation, u32 ms );
+/// @brief Signal event, waking one waiter.
+/// @param[in] event Event to signal.
+void event_signal( Event* event );
+/// @brief Signal event, waking every waiter.
+/// @param[in] event Event to signal.
+void event_signal_all( Event* event );
+/// @brief Destroy event.
+/// @param[in] event Event to destroy.
+void event_destroy( Event* event );
+
+/// @brief Create an adaptive spin mutex.
+/// @param[out] out_mutex Pointer to write mutex to.
+/// @return
+///     - @c True : Created mutex successfully.
+b32 spin_mutex_create( SpinMutex* out_mutex );
+/// @brief Attempt to lock spin mutex without waiting.
+/// @param[in] mutex Mutex to lock.
+/// @return
+///     - @c True  : Locked mutex.
+///     - @c False : Mutex is held by another thread.
+b32 spin_mutex_try_lock( SpinMutex* mutex );
+/// @brief Lock spin mutex.
+/// @details
+/// Spins briefly before parking in the kernel so short critical
+/// sections never pay for a kernel round-trip.
+/// @param[in] mutex Mutex to lock.
+void spin_mutex_lock( SpinMutex* mutex );
+/// @brief Unlock locked spin mutex.
+/// @param[in] mutex Mutex to unlock.
+void spin_mutex_unlock( SpinMutex* mutex );
+/// @brief Destroy spin mutex.
+/// @param[in] mutex Mutex to destroy.
+void spin_mutex_destroy( SpinMutex* mutex );
+
 /// @brief Sleep the current thread for given milliseconds.
 /// @param ms Milliseconds to sleep for.
 void thread_sleep( u32 ms );
 
 /// @brief Enqueue a new job.
+/// @details
+/// Jobs are pushed to the calling thread's deque and idle worker
+/// threads steal from other deques, so enqueueing never fails
+/// for capacity reasons, deques grow as needed.
 /// @param[in] job    Pointer to job function to enqueue.
 /// @param[in] params (optional) Parameters for job function.
 /// @return
-///     - @c True  : Was able to enqueue job.
-///     - @c False : Job queue is full, use job_enqueue_timed() instead to wait for empty spot.
+///     - @c True  : Job was enqueued.
 b32 job_enqueue( JobFN* job, void* params );
-/// @brief Wait for job queue to enqueue.
+/// @brief Enqueue a new job.
+/// @details
+/// Kept for compatibility, job deques grow as needed so
+/// this is now the same as calling job_enqueue().
 /// @param[in] job    Pointer to job function to enqueue.
 /// @param[in] params (optional) Parameters for job function.
-/// @param     ms     Maximum milliseconds to wait, use MT_WAIT_INFINITE to wait indefinitely.
+/// @param     ms     Unused.
 /// @return
-///     - @c True  : Was able to enqueue in time.
-///     - @c False : Timed out.
+///     - @c True  : Job was enqueued.
 b32 job_enqueue_timed( JobFN* job, void* params, u32 ms );
 /// @brief Wait for next job to complete.
 /// @param ms Milliseconds to wait for, use MT_WAIT_INFINITE to wait indefinitely.
@@ -1587,6 +2445,40 @@ b32 job_wait_next( u32 ms );
 ///      - @c False : Timed out.
 b32 job_wait_all( u32 ms );
 
+/// @brief Add a job to the job graph.
+/// @details
+/// Job is enqueued as soon as all of its dependencies have completed,
+/// without any barrier in between. A job with no dependencies is
+/// enqueued immediately.
+/// @param[in] job              Pointer to job function.
+/// @param[in] params           (optional) Parameters for job function.
+/// @param     dependency_count Number of dependencies.
+/// @param[in] dependencies     (optional) Pointer to array of job IDs this job depends on.
+/// @return ID of job in graph.
+JobID job_graph_add(
+    JobFN* job, void* params, usize dependency_count, const JobID* dependencies );
+/// @brief Wait for a job in the job graph to complete.
+/// @param id Job ID to wait for.
+/// @param ms Milliseconds to wait for, use MT_WAIT_INFINITE to wait indefinitely.
+/// @return
+///      - @c True  : Job completed in time.
+///      - @c False : Timed out.
+b32 job_graph_wait( JobID id, u32 ms );
+/// @brief Wait for all jobs in the job graph to complete.
+/// @details
+/// Unlike job_wait_all(), this also waits for jobs that
+/// have not been released into the queue yet.
+/// @param ms Milliseconds to wait for, use MT_WAIT_INFINITE to wait indefinitely.
+/// @return
+///      - @c True  : Jobs completed in time or graph was empty.
+///      - @c False : Timed out.
+b32 job_graph_wait_all( u32 ms );
+/// @brief Clear the job graph, freeing all completed jobs.
+/// @warning
+/// Only call when all jobs in the graph have completed.
+/// Previously returned job IDs are invalid after this call.
+void job_graph_clear(void);
+
 /// @brief Get the current thread's monotonic id.
 /// @return Current thread id. (0 is main thread)
 u32 thread_id(void);
@@ -1652,6 +2544,32 @@ b32 command_builder_append_list(
 /// @param[in] builder Builder to convert.
 /// @return Command.
 Command command_builder_cmd( CommandBuilder* builder );
+/// @brief Get flattened command line of builder.
+/// @details
+/// Flattened form is cached inside the builder so repeated calls
+/// (logging, hashing) only pay for the flatten when arguments changed.
+/// @param[in] builder Builder to flatten.
+/// @return
+///     - String view of flattened command line.
+///       Valid until next push or free.
+///     - Empty string : Failed to allocate flattened command line.
+String command_builder_flatten( CommandBuilder* builder );
+/// @brief Spill builder arguments to a response file.
+/// @details
+/// Writes every argument after the executable name to @c path, one per
+/// line, and writes a two argument command (executable, \@path) to
+/// @c out_cmd. Toolchains that accept \@file response files (gcc, clang,
+/// msvc) read arguments from the file, keeping the command line short
+/// no matter how many arguments were pushed. The resulting command is
+/// valid until the builder is freed or this function is called again.
+/// @param[in]  builder Builder to spill.
+/// @param[in]  path    Path to write response file to.
+/// @param[out] out_cmd Pointer to write command to.
+/// @return
+///     - true  : Wrote response file and command successfully.
+///     - false : Failed to write response file or allocate command.
+b32 command_builder_cmd_response(
+    CommandBuilder* builder, const char* path, Command* out_cmd );
 /// @brief Free command builder.
 /// @param[in] builder Builder to free.
 void command_builder_free( CommandBuilder* builder );
@@ -1702,6 +2620,35 @@ void pipe_close( Pipe pipe );
 ///     - @c True  : Process is in path.
 ///     - @c False : Process is not in path.
 b32 process_in_path( const char* process_name );
+/// @brief Resolve an executable name to a full path.
+/// @details
+/// The first call scans every directory in the PATH environment
+/// variable once and builds an in-memory index of executables;
+/// later lookups are answered from the index without touching the
+/// filesystem or spawning a process. Names containing a path
+/// separator are returned unchanged if they point to an executable.
+/// @param[in] process_name Null-terminated name of executable.
+/// @return
+///     - @c Pointer : Null-terminated path to executable. Lives until program exit.
+///     - @c NULL    : Executable was not found.
+const char* process_resolve( const char* process_name );
+/// @brief Load executable resolutions persisted by process_resolve_save().
+/// @details
+/// Resolutions are keyed by a hash of PATH; a file saved under a
+/// different PATH is ignored so a changed environment never serves
+/// stale tool paths. Call before the first process_resolve() to
+/// answer tool probes without scanning PATH at all.
+/// @param[in] path Null-terminated path to tools file.
+/// @return
+///     - @c True  : Resolutions were loaded and match current PATH.
+///     - @c False : File is missing, invalid or from a different PATH.
+b32 process_resolve_load( const char* path );
+/// @brief Persist every executable resolved so far to @c path.
+/// @param[in] path Null-terminated path to tools file.
+/// @return
+///     - @c True  : Resolutions were saved.
+///     - @c False : Failed to write file.
+b32 process_resolve_save( const char* path );
 /// @brief Execute a process command.
 /// @param cmd Command to execute.
 /// @param redirect_void If output should just be redirected to void.
@@ -1742,6 +2689,327 @@ b32 process_wait_timed( PID pid, int* opt_out_res, u32 ms );
 /// @param pid Process ID to discard.
 void process_discard( PID pid );
 
+/// @brief Open a process pool.
+/// @details
+/// Starts the pool's reaper thread. At most @c max_parallel submitted
+/// commands execute at any time, the rest wait in the pool's queue.
+/// Use instead of blocking job queue threads in process_wait().
+/// @param      max_parallel Maximum concurrent commands. Must be >= 1.
+/// @param[out] out_pool     Pointer to write pool to.
+/// @return
+///     - @c True  : Pool was opened.
+///     - @c False : Failed to allocate pool.
+b32 process_pool_open( u32 max_parallel, ProcessPool* out_pool );
+/// @brief Submit a command to a process pool.
+/// @details
+/// Does not block, command executes as soon as a slot is free.
+/// @c cmd args and @c opt_params must stay valid until @c opt_callback
+/// runs or the pool is drained. Callbacks run on the reaper thread,
+/// one at a time.
+/// @param[in] pool         Pool to submit to.
+/// @param     cmd          Command to execute.
+/// @param[in] opt_callback (optional) Function to call when command completes.
+/// @param[in] opt_params   (optional) Pointer to additional parameters for callback.
+/// @return
+///     - @c True  : Command was queued.
+///     - @c False : Failed to allocate queue entry.
+b32 process_pool_submit(
+    ProcessPool* pool, Command cmd,
+    ProcessPoolFN* opt_callback, void* opt_params );
+/// @brief Block until every submitted command has completed.
+/// @param[in] pool Pool to drain.
+void process_pool_drain( ProcessPool* pool );
+/// @brief Close a process pool.
+/// @details
+/// Drains pool, stops its reaper thread and frees pool memory.
+/// @param[in] pool Pool to close.
+void process_pool_close( ProcessPool* pool );
+
+/// @brief Open a pipe capture engine.
+/// @details
+/// Starts the engine's capture thread, which drains every submitted
+/// pipe into its own buffer without blocking on any one of them.
+/// Use with process_exec()'s redirect parameters to collect
+/// diagnostics from many children at once, one thread total.
+/// @param[out] out_capture Pointer to write engine to.
+/// @return
+///     - @c True  : Engine was opened.
+///     - @c False : Failed to allocate engine.
+b32 pipe_capture_open( PipeCapture* out_capture );
+/// @brief Submit the read end of a pipe to a capture engine.
+/// @details
+/// The engine owns @c pipe from here on and closes it when the write
+/// end closes; hand the write end to process_exec() and pipe_close()
+/// it in the parent or the pipe never reports closed. When it does,
+/// @c callback runs on the capture thread, one at a time, with
+/// everything the pipe produced.
+/// @param[in] capture    Engine to submit to.
+/// @param     pipe       Read end of pipe to drain.
+/// @param[in] callback   Function to call when pipe closes.
+/// @param[in] opt_params (optional) Pointer to additional parameters for callback.
+/// @return
+///     - @c True  : Pipe was submitted.
+///     - @c False : Failed to allocate capture entry.
+b32 pipe_capture_submit(
+    PipeCapture* capture, ReadPipe pipe,
+    PipeCaptureFN* callback, void* opt_params );
+/// @brief Block until every submitted pipe has closed.
+/// @param[in] capture Engine to drain.
+void pipe_capture_drain( PipeCapture* capture );
+/// @brief Close a pipe capture engine.
+/// @details
+/// Drains engine, stops its capture thread and frees engine memory.
+/// @param[in] capture Engine to close.
+void pipe_capture_close( PipeCapture* capture );
+
+/// @brief Register a remote worker for command execution.
+/// @details
+/// Remote execution is opt-in: nothing talks to a worker until one is
+/// registered. Workers are reached over ssh and need tar available on
+/// both ends; @c destination is anything ssh accepts ("user@host").
+/// Commands run inside @c workdir on the worker, which is created on
+/// first ship. Remote workers are not supported on Windows hosts.
+/// @param[in] destination  Null-terminated ssh destination.
+/// @param[in] workdir      Null-terminated remote working directory.
+/// @param     max_parallel Commands this worker should run concurrently.
+/// @return
+///     - @c True  : Worker was registered.
+///     - @c False : Failed to allocate worker.
+b32 remote_worker_add(
+    const char* destination, const char* workdir, u32 max_parallel );
+/// @brief Query number of registered remote workers.
+/// @return Number of workers registered with remote_worker_add().
+usize remote_worker_count(void);
+/// @brief Copy input files to a remote worker.
+/// @details
+/// Files are content-hashed with hash_file_batch() and compared
+/// against what was already shipped to this worker; only new or
+/// changed files are transferred, in one tar-over-ssh stream.
+/// Relative paths are recreated relative to the worker's workdir.
+/// @param     worker Index of worker, < remote_worker_count().
+/// @param     count  Number of files to ship.
+/// @param[in] paths  Pointer to @c count null-terminated paths.
+/// @return
+///     - @c True  : Worker is up to date.
+///     - @c False : Hashing or transfer failed.
+b32 remote_ship( usize worker, usize count, const char** paths );
+/// @brief Copy result files back from a remote worker.
+/// @details
+/// Files are read relative to the worker's workdir and written
+/// relative to the current directory, in one tar-over-ssh stream.
+/// @param     worker Index of worker, < remote_worker_count().
+/// @param     count  Number of files to fetch.
+/// @param[in] paths  Pointer to @c count null-terminated paths.
+/// @return
+///     - @c True  : Files were fetched.
+///     - @c False : Transfer failed.
+b32 remote_fetch( usize worker, usize count, const char** paths );
+/// @brief Execute a command on a remote worker.
+/// @details
+/// Command runs inside the worker's workdir; ship inputs with
+/// remote_ship() first and collect outputs with remote_fetch().
+/// Output streams to the local stdout/stderr like process_exec().
+/// @param worker Index of worker, < remote_worker_count().
+/// @param cmd    Command to execute.
+/// @return ID of local ssh process, wait on it like any process_exec() result.
+PID remote_exec( usize worker, Command cmd );
+/// @brief Submit a command to a process pool for remote execution.
+/// @details
+/// Ships @c inputs to the least loaded remote worker, then submits
+/// the command wrapped in ssh so the pool's bounded parallelism and
+/// completion callbacks work unchanged. The callback receives the
+/// original command, not the ssh wrapper. With no registered workers
+/// this is plain process_pool_submit() and inputs are ignored.
+/// @c cmd.args and @c inputs must stay valid until the callback runs.
+/// @param[in] pool         Pool to submit to.
+/// @param     cmd          Command to execute remotely.
+/// @param     input_count  Number of input files to ship.
+/// @param[in] inputs       Pointer to @c input_count null-terminated paths.
+/// @param[in] opt_callback (optional) Function to call when command completes.
+/// @param[in] opt_params   (optional) Parameters to callback.
+/// @return
+///     - @c True  : Command was submitted.
+///     - @c False : Shipping inputs failed or allocation failed.
+b32 process_pool_submit_remote(
+    ProcessPool* pool, Command cmd, usize input_count, const char** inputs,
+    ProcessPoolFN* opt_callback, void* opt_params );
+
+/// @brief Hash buffer with a fast, non-cryptographic 64-bit hash.
+/// @details
+/// Stable across runs and platforms so hashes can be written to disk.
+/// Not suitable for anything security-related.
+/// @param[in] len Length of buffer in bytes.
+/// @param[in] buf Pointer to start of buffer.
+/// @return 64-bit hash of buffer.
+u64 hash_buffer( usize len, const void* buf );
+/// @brief Hash a string slice. Equivalent to hash_buffer().
+/// @param[in] str (String) String to hash.
+/// @return (u64) 64-bit hash of string.
+#define hash_string( str )\
+    hash_buffer( (str).len, (str).cc )
+/// @brief Hash contents of file at given path.
+/// @param[in]  path     Null-terminated path to file. Length must be <= 4096.
+/// @param[out] out_hash Pointer to write hash to.
+/// @return
+///     - @c True  : File was read and hashed.
+///     - @c False : Failed to open or map file.
+b32 hash_file( const char* path, u64* out_hash );
+/// @brief Hash contents of multiple files in parallel.
+/// @details
+/// Files are hashed on the job queue, one job per file, and this
+/// call blocks until every file has been hashed. Hashes are written
+/// to @c out_hashes in the same order as @c paths. Entries for files
+/// that could not be hashed are left untouched.
+/// @param[in]  count      Number of files to hash.
+/// @param[in]  paths      Pointer to @c count null-terminated paths.
+/// @param[out] out_hashes Pointer to @c count hashes to write to.
+/// @return
+///     - @c True  : All files were hashed.
+///     - @c False : One or more files could not be hashed.
+b32 hash_file_batch( usize count, const char** paths, u64* out_hashes );
+
+/// @brief Open a build cache, loading its manifest if it exists.
+/// @details
+/// If @c manifest_path does not exist, cache starts out empty and
+/// manifest is created by the next build_cache_save().
+/// @param[in]  manifest_path Path to manifest file. Length must be <= 4096.
+/// @param[out] out_cache     Pointer to write cache to.
+/// @return
+///     - @c True  : Cache was opened (manifest loaded or cache is empty).
+///     - @c False : Manifest exists but could not be read or parsed.
+b32 build_cache_open( const char* manifest_path, BuildCache* out_cache );
+/// @brief Check if target needs to be rebuilt.
+/// @details
+/// Target is dirty when any of the following is true:
+///
+/// - Target has no entry in cache or target file does not exist.
+/// - Hash of @c opt_cmd differs from recorded command hash.
+/// - Set of inputs differs from recorded inputs.
+/// - Any input's content hash differs from its recorded hash.
+///
+/// Input content is only re-hashed when its time modified changed,
+/// so mtime-only churn (checkout/touch) does not force a rebuild.
+/// @param[in] cache       Cache to check against.
+/// @param[in] target      Path of target output file.
+/// @param[in] opt_cmd     (optional) Command that builds target.
+/// @param     input_count Number of input paths.
+/// @param[in] inputs      Pointer to array of null-terminated input paths.
+/// @return
+///     - @c True  : Target must be rebuilt.
+///     - @c False : Target is up to date.
+b32 build_cache_is_dirty(
+    BuildCache* cache, const char* target, const Command* opt_cmd,
+    usize input_count, const char** inputs );
+/// @brief Record current state of target and its inputs in cache.
+/// @details
+/// Call after successfully building @c target.
+/// Replaces existing entry for @c target if there is one.
+/// @param[in] cache       Cache to update.
+/// @param[in] target      Path of target output file.
+/// @param[in] opt_cmd     (optional) Command that builds target.
+/// @param     input_count Number of input paths.
+/// @param[in] inputs      Pointer to array of null-terminated input paths.
+/// @return
+///     - @c True  : Entry was recorded.
+///     - @c False : Failed to allocate entry.
+b32 build_cache_update(
+    BuildCache* cache, const char* target, const Command* opt_cmd,
+    usize input_count, const char** inputs );
+/// @brief Write manifest of build cache to disk.
+/// @param[in] cache Cache to save.
+/// @return
+///     - @c True  : Manifest was written successfully.
+///     - @c False : Failed to write manifest.
+b32 build_cache_save( BuildCache* cache );
+/// @brief Free a build cache. Does not save manifest.
+/// @param[in] cache Cache to free.
+void build_cache_free( BuildCache* cache );
+
+/// @brief Open a dependency index, loading its on-disk cache if it exists.
+/// @details
+/// If @c index_path does not exist, index starts out empty and
+/// index file is created by the next dep_index_save().
+/// Include directories are not persisted, add them with
+/// dep_index_add_include_dir() after every open.
+/// @param[in]  index_path Path to index file. Length must be <= 4096.
+/// @param[out] out_index  Pointer to write index to.
+/// @return
+///     - @c True  : Index was opened (index file loaded or index is empty).
+///     - @c False : Index file exists but could not be read or parsed.
+b32 dep_index_open( const char* index_path, DepIndex* out_index );
+/// @brief Add an include directory to search when resolving includes.
+/// @param[in] index Index to add directory to.
+/// @param[in] dir   Path of include directory.
+/// @return
+///     - @c True  : Directory was added.
+///     - @c False : Failed to allocate path.
+b32 dep_index_add_include_dir( DepIndex* index, const char* dir );
+/// @brief Scan a source file and its headers for include dependencies.
+/// @details
+/// Lexes @c path for @c #include directives, resolves them against the
+/// directory of the including file (quoted includes only) and the
+/// configured include directories, and recursively scans every header
+/// that resolves to an existing file. Includes that do not resolve
+/// (system headers) are skipped. Files whose time modified is unchanged
+/// since they were last scanned are not lexed again.
+/// @param[in] index Index to scan into.
+/// @param[in] path  Path of source file.
+/// @return
+///     - @c True  : File was scanned.
+///     - @c False : File does not exist or could not be read.
+b32 dep_index_scan( DepIndex* index, const char* path );
+/// @brief Get latest time modified of file and its transitive includes.
+/// @details
+/// Scans @c path with dep_index_scan() and returns the largest time
+/// modified over the file and every header it transitively includes.
+/// Compare against the target's time modified to check staleness.
+/// @param[in] index Index to query.
+/// @param[in] path  Path of source file.
+/// @return Latest time modified, or 0 if @c path could not be scanned.
+time_t dep_index_time_modify( DepIndex* index, const char* path );
+/// @brief Write dependency index to disk.
+/// @param[in] index Index to save.
+/// @return
+///     - @c True  : Index was written successfully.
+///     - @c False : Failed to write index.
+b32 dep_index_save( DepIndex* index );
+/// @brief Free a dependency index. Does not save index file.
+/// @param[in] index Index to free.
+void dep_index_free( DepIndex* index );
+
+/// @brief Open a compiler cache, creating its directory if necessary.
+/// @param[in]  dir       Path of cache directory. Length must be <= 4096.
+/// @param[out] out_cache Pointer to write cache to.
+/// @return
+///     - @c True  : Cache directory exists or was created.
+///     - @c False : Failed to create cache directory.
+b32 compiler_cache_open( const char* dir, CompilerCache* out_cache );
+/// @brief Execute a compile command through the cache.
+/// @details
+/// Cache key is the hash of @c cmd flattened together with the
+/// content hashes of every input. On hit, the cached object is
+/// copied to @c output instead of spawning the compiler. On miss,
+/// @c cmd is executed and @c output is stored in the cache when the
+/// command succeeds. Inputs must cover everything that affects the
+/// object, including headers (see dep_index_scan()), otherwise stale
+/// objects are served.
+/// @param[in]  cache       Cache to execute through.
+/// @param[in]  cmd         Command that produces @c output.
+/// @param[in]  output      Path of object file @c cmd produces.
+/// @param[in]  input_count Number of inputs.
+/// @param[in]  inputs      Pointer to @c input_count null-terminated paths.
+/// @param[out] opt_out_res (optional) Pointer to write return code to.
+/// Zero on cache hit, otherwise same convention as process_wait().
+/// @return
+///     - @c True  : Output was produced, from cache or by @c cmd.
+///     - @c False : Inputs could not be hashed or @c cmd failed.
+b32 compiler_cache_exec(
+    CompilerCache* cache, const Command* cmd, const char* output,
+    usize input_count, const char** inputs, int* opt_out_res );
+/// @brief Free a compiler cache. Cached objects stay on disk.
+/// @param[in] cache Cache to free.
+void compiler_cache_free( CompilerCache* cache );
+
 /// @brief Get current time in milliseconds.
 /// @return Time in milliseconds.
 f64 timer_milliseconds(void);
@@ -1749,39 +3017,87 @@ f64 timer_milliseconds(void);
 /// @return Time in seconds.
 f64 timer_seconds(void);
 
-/// @brief Get pointer to next local byte buffer.
+/// @brief Begin capturing a profiling trace.
+/// @details
+/// Events are recorded into per-thread buffers with no locking, so
+/// tracing is cheap enough to leave on in production. process_exec(),
+/// process_wait(), path_walk_dir() and job dispatch are instrumented
+/// already, use trace_event_begin()/trace_event_end() or
+/// trace_scope() for your own events. Trace is written by trace_end()
+/// or automatically at exit.
+/// @param[in] path Path to write Chrome trace_event JSON to.
+/// Open with chrome://tracing or https://ui.perfetto.dev.
+void trace_begin( const char* path );
+/// @brief Stop capturing and write trace to disk.
+/// @details
+/// Call when no other thread is recording events, e.g. after
+/// job_wait_all(). Does nothing when no trace is active.
+void trace_end(void);
+/// @brief Record the start of a timed event on the current thread.
+/// @details
+/// Pair with trace_event_end(). Events may nest up to 32 deep.
+/// Does nothing when no trace is active.
+/// @param[in] name Name of event. Contents are not copied so it must
+/// be a literal or otherwise outlive the trace.
+void trace_event_begin( const char* name );
+/// @brief Record the end of the last event begun on the current thread.
+void trace_event_end(void);
+/// @brief Run the statement or block that follows as a named trace event.
+/// @param[in] name (const char* literal) Name of event,
+/// same rules as trace_event_begin().
+#define trace_scope( name )\
+    for(\
+        b32 _trace_once_ = ( trace_event_begin( name ), true );\
+        _trace_once_;\
+        trace_event_end(), _trace_once_ = false )
+
+/// @brief Open a scope in the current thread's scratch arena.
+/// @details
+/// Scratch arenas are per-thread and growable. Inside a scope,
+/// scratch_alloc()/local_byte_buffer()/local_fmt() can create any
+/// number of temporaries and everything allocated since the matching
+/// scratch_begin() is released in bulk by scratch_end().
+/// Scopes nest and must be closed in LIFO order.
+/// @return Scope to pass to scratch_end().
+ScratchScope scratch_begin(void);
+/// @brief Close a scratch scope.
+/// @details
+/// Releases everything the current thread allocated from its scratch
+/// arena since the matching scratch_begin().
+/// @warning
+/// Pointers obtained inside the scope are invalid after this.
+/// @param scope Scope created by the matching scratch_begin().
+void scratch_end( ScratchScope scope );
+/// @brief Allocate zeroed memory from the current thread's scratch arena.
+/// @details
+/// One pointer bump per allocation, no locks, do not free the result.
+/// Outside of any scratch scope, allocations are recycled once the
+/// arena's first block fills up, so use the result immediately or
+/// open a scope with scratch_begin().
+/// @param size Size of allocation in bytes.
+/// @return Pointer to start of allocation.
+void* scratch_alloc( usize size );
+/// @brief Get pointer to a zeroed local byte buffer of
+/// CBUILD_LOCAL_BUFFER_CAPACITY bytes.
 /// @details
-/// cbuild allocates CBUILD_LOCAL_BUFFER_COUNT * CBUILD_THREAD_COUNT
-/// number of buffers of size CBUILD_LOCAL_BUFFER_CAPACITY
-/// when either init() or this function is first called.
-/// Local buffers should not be freed.
-/// Local buffers should be used immediately to prevent
-/// other functions from overwriting the currently obtained
-/// local buffer.
-/// @return Pointer to next local byte buffer.
+/// Allocated from the current thread's scratch arena,
+/// same rules as scratch_alloc().
+/// @return Pointer to local byte buffer.
 u8* local_byte_buffer(void);
-/// @brief Write formatted string to local buffer.
+/// @brief Write formatted string to a local buffer.
 /// @details
-/// cbuild allocates CBUILD_LOCAL_BUFFER_COUNT * CBUILD_THREAD_COUNT
-/// number of buffers of size CBUILD_LOCAL_BUFFER_CAPACITY
-/// when either init() or this function is first called.
-/// Local buffers should not be freed.
-/// Local buffers should be used immediately to prevent
-/// other functions from overwriting the currently obtained
-/// local buffer.
+/// Buffer is allocated from the current thread's scratch arena,
+/// same rules as scratch_alloc(). Output is clamped to
+/// CBUILD_LOCAL_BUFFER_CAPACITY bytes including the null-terminator.
 /// @param[in] format Format string literal.
 /// @param     va     Variadic list of format arguments.
 /// @return Pointer to start of formatted local buffer.
 char* local_fmt_va( const char* format, va_list va );
-/// @brief Write formatted string to local buffer.
+/// @brief Write formatted string to a local buffer.
 /// @details
-/// cbuild allocates CBUILD_LOCAL_BUFFER_COUNT * CBUILD_THREAD_COUNT
-/// number of buffers of size CBUILD_LOCAL_BUFFER_CAPACITY
-/// when either init() or this function is first called.
-/// Local buffers should not be freed.
-/// Local buffers should be used immediately to prevent
-/// other functions from overwriting the currently obtained
-/// local buffer.
+/// Buffer is allocated from the current thread's scratch arena,
+/// same rules as scratch_alloc(). Output is clamped to
+/// CBUILD_LOCAL_BUFFER_CAPACITY bytes including the null-terminator.
 /// @param[in] format Format string literal.
 /// @param     ...    Format arguments.
 /// @return Pointer to start of formatted local buffer.
@@ -1806,6 +3122,21 @@ void logger_va( LoggerLevel level, const char* format, va_list va );
 /// @param[in] format Format string literal.
 /// @param     ...    Format arguments.
 void logger( LoggerLevel level, const char* format, ... );
+/// @brief Enable or disable asynchronous logging.
+/// @details
+/// When enabled, info and warning messages are appended to a
+/// per-thread staging buffer instead of being written out under the
+/// logger mutex. Staged messages are written when a staging buffer
+/// fills up, periodically by a background writer thread, by
+/// job_wait_all() and by logger_flush(). Whole lines are never split
+/// across writes. Error and fatal messages always write through
+/// immediately so they are not lost if the program crashes.
+/// @param async If asynchronous logging should be enabled.
+void logger_set_async( b32 async );
+/// @brief Write out staged messages of every thread.
+/// @details
+/// Does nothing if asynchronous logging was never enabled.
+void logger_flush(void);
 
 /// @brief Query name of compiler used to compile this instance of cbuild.
 /// @details
@@ -1922,6 +3253,21 @@ void _init_(
 #include <string.h>
 #include <ctype.h>
 
+// define CBUILD_SIMD_DISABLE to force scalar string search kernels.
+#if !defined(CBUILD_SIMD_DISABLE)
+    #if defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define CBUILD_SIMD_SSE2
+        #include <emmintrin.h>
+        #if defined(COMPILER_MSVC)
+            #include <intrin.h>
+        #endif
+    #elif defined(__ARM_NEON)
+        #define CBUILD_SIMD_NEON
+        #include <arm_neon.h>
+    #endif
+#endif
+
 #if defined(PLATFORM_WINDOWS)
     #include <process.h>
 #else
@@ -1937,17 +3283,25 @@ struct GlobalBuffers {
     ReadPipe  void_read;
     WritePipe void_write;
 };
-struct LocalBuffers {
-    char buffers[CBUILD_THREAD_COUNT + 1]
-        [CBUILD_LOCAL_BUFFER_COUNT][CBUILD_LOCAL_BUFFER_CAPACITY];
-    atom indices[CBUILD_THREAD_COUNT + 1];
+struct ScratchBlock {
+    struct ScratchBlock* next;
+    usize cap;
+    u8    buf[];
+};
+struct Scratch {
+    struct ScratchBlock* first;
+    struct ScratchBlock* current;
+    usize at;    // offset of next allocation in current block.
+    u32   depth; // number of open scopes.
 };
 struct DynamicString {
     usize len, cap;
+    Arena* arena; // null when allocated from the heap.
     char  buf[];
 };
 struct DynamicArray {
     usize len, cap, stride;
+    Arena* arena; // null when allocated from the heap.
     u8 buf[];
 };
 
@@ -1955,11 +3309,26 @@ struct JobEntry {
     JobFN* proc;
     void*  params;
 };
+struct JobBuffer {
+    usize cap; // always a power of two
+    struct JobEntry entries[];
+};
+struct JobDeque {
+    atom64 top;    // next index to steal from, thieves advance it with CAS.
+    atom64 bottom; // next index to push to, only touched by owner thread.
+    struct JobBuffer* volatile buf;
+    // buffers retired by growing, stealers may still be reading
+    // from them so they are kept around until cbuild exits.
+    struct JobBuffer* retired[24];
+    usize retired_count;
+};
 struct JobQueue {
-    Semaphore wakeup;
-    atom front, back;
-    atom pending, len;
-    struct JobEntry entries[CBUILD_MAX_JOBS];
+    Event wakeup;   // signaled per enqueued job.
+    Event complete; // signaled per completed job.
+    atom pending;
+    // one deque per thread that can enqueue jobs,
+    // including service threads.
+    struct JobDeque deques[CBUILD_THREAD_COUNT + CBUILD_SERVICE_THREAD_COUNT + 1];
 };
 
 volatile struct JobQueue* global_queue = NULL;
@@ -1967,6 +3336,24 @@ volatile struct JobQueue* global_queue = NULL;
 atom   global_is_mt              = false; // boolean
 atom64 global_memory_usage       = 0;
 atom64 global_total_memory_usage = 0;
+atom64 global_memory_peak        = 0;
+atom64 global_memory_tag_usage[MEMORY_TAG_COUNT] = {0};
+atom64 global_memory_tag_peak[MEMORY_TAG_COUNT]  = {0};
+make_tls( MemoryTag ) global_memory_tag = MEMORY_TAG_GENERAL;
+
+// NOTE(alicia): internal subsystems only claim allocations that
+// would otherwise land in the general tag so that user scopes
+// opened with memory_tag_set() keep ownership of nested allocations.
+static MemoryTag memory_tag_enter( MemoryTag tag ) {
+    MemoryTag previous = global_memory_tag;
+    if( previous == MEMORY_TAG_GENERAL ) {
+        global_memory_tag = tag;
+    }
+    return previous;
+}
+static void memory_tag_leave( MemoryTag previous ) {
+    global_memory_tag = previous;
+}
 
 atom            global_thread_id_source = 1; // 0 is main thread
 make_tls( u32 ) global_thread_id        = 0;
@@ -1974,9 +3361,26 @@ make_tls( u32 ) global_thread_id        = 0;
 static Mutex       global_logger_mutex = mutex_null();
 static LoggerLevel global_logger_level = LOGGER_LEVEL_INFO;
 
+// NOTE(alicia): guards the executable resolver tables, see process_resolve().
+static Mutex global_process_resolve_mutex = mutex_null();
+
+/// @brief Capacity of per-thread logger staging buffers.
+#define CBUILD_LOGGER_STAGE_CAPACITY CBUILD_LOCAL_BUFFER_CAPACITY
+
+struct LoggerStage {
+    struct LoggerStage* next;
+    Mutex lock;
+    usize len;
+    char  buf[CBUILD_LOGGER_STAGE_CAPACITY];
+};
+make_tls( struct LoggerStage* ) global_logger_stage = NULL;
+static struct LoggerStage* volatile global_logger_stage_list = NULL;
+static atom global_logger_async       = 0;
+static atom global_logger_writer_live = 0;
+
 static Command global_command_line;
 
-volatile struct LocalBuffers* global_local_buffers = NULL;
+make_tls( struct Scratch* ) global_scratch = NULL;
 #if defined(COMPILER_MSVC)
     volatile struct GlobalBuffers global_buffers = {0};
 #else
@@ -1987,23 +3391,220 @@ volatile struct LocalBuffers* global_local_buffers = NULL;
 void  thread_create( JobFN* func, void* params );
 char* internal_cwd(void);
 char* internal_home(void);
-static b32 path_walk_dir_internal(
-    DString** path, b32 recursive, b32 include_dirs,
-    usize* out_count, DString** out_buffer );
-
-static b32 job_dequeue( struct JobQueue* queue, struct JobEntry* out_entry ) {
-    if( !queue->len ) {
-        return false;
+static void initialize_mt(void) {
+    if( global_is_mt ) {
+        return;
+    }
+    expect( mutex_create( &global_logger_mutex ), "failed to create logger mutex!" );
+    expect( mutex_create( &global_process_resolve_mutex ),
+        "failed to create resolver mutex!" );
+    atomic_add( &global_is_mt, 1 );
+}
+#define CBUILD_TRACE_DEPTH (32)
+struct TraceEvent {
+    const char* name;
+    f64         ts;
+    f64         dur;
+};
+struct TraceThread {
+    u32 len;
+    u32 dropped;
+    u32 depth;
+    struct { const char* name; f64 ts; } stack[CBUILD_TRACE_DEPTH];
+    struct TraceEvent events[CBUILD_TRACE_CAPACITY];
+};
+struct Trace {
+    DString* path;
+    struct TraceThread
+        threads[CBUILD_THREAD_COUNT + CBUILD_SERVICE_THREAD_COUNT + 1];
+};
+static struct Trace* volatile global_trace = NULL;
+
+void trace_begin( const char* path ) {
+    assertion( path, "no path provided!" );
+    if( global_trace ) {
+        return;
+    }
+    struct Trace* trace = memory_alloc( sizeof(*trace) );
+    expect( trace, "failed to allocate trace! size: %zu", sizeof(*trace) );
+    trace->path = dstring_from_cstr( path );
+    expect( trace->path, "failed to allocate trace path!" );
+
+    atexit( trace_end );
+    fence();
+    global_trace = trace;
+}
+void trace_event_begin( const char* name ) {
+    struct Trace* trace = global_trace;
+    if( !trace ) {
+        return;
+    }
+    struct TraceThread* thread = trace->threads + thread_id();
+    if( thread->depth < CBUILD_TRACE_DEPTH ) {
+        thread->stack[thread->depth].name = name;
+        thread->stack[thread->depth].ts   = timer_milliseconds();
+    }
+    thread->depth++;
+}
+void trace_event_end(void) {
+    struct Trace* trace = global_trace;
+    if( !trace ) {
+        return;
+    }
+    struct TraceThread* thread = trace->threads + thread_id();
+    if( !thread->depth ) {
+        return;
+    }
+    if( --thread->depth >= CBUILD_TRACE_DEPTH ) {
+        return;
+    }
+    if( thread->len >= CBUILD_TRACE_CAPACITY ) {
+        thread->dropped++;
+        return;
+    }
+    struct TraceEvent* event = thread->events + thread->len++;
+    event->name = thread->stack[thread->depth].name;
+    event->ts   = thread->stack[thread->depth].ts;
+    event->dur  = timer_milliseconds() - event->ts;
+}
+void trace_end(void) {
+    struct Trace* trace = global_trace;
+    if( !trace ) {
+        return;
+    }
+    global_trace = NULL;
+    fence();
+    // give other threads a tick to finish in-flight records.
+    thread_sleep( 1 );
+
+    FD output;
+    if( !fd_open(
+        trace->path, FOPEN_WRITE | FOPEN_CREATE | FOPEN_TRUNCATE, &output )
+    ) {
+        cb_error( "trace_end: failed to open '%s'!", trace->path );
+    } else {
+        fd_write_fmt( &output, "{\"traceEvents\":[" );
+        b32 first = true;
+        for( u32 i = 0; i < static_array_len( trace->threads ); ++i ) {
+            struct TraceThread* thread = trace->threads + i;
+            if( thread->dropped ) {
+                cb_warn(
+                    "trace_end: thread %u dropped %u events! "
+                    "define CBUILD_TRACE_CAPACITY to raise the limit.",
+                    i, thread->dropped );
+            }
+            for( u32 j = 0; j < thread->len; ++j ) {
+                struct TraceEvent* event = thread->events + j;
+                fd_write_fmt( &output,
+                    "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,"
+                    "\"ts\":%f,\"dur\":%f}",
+                    first ? "" : ",", event->name, i,
+                    event->ts * 1000.0, event->dur * 1000.0 );
+                first = false;
+            }
+        }
+        fd_write_fmt( &output, "\n]}\n" );
+        fd_close( &output );
+    }
+
+    dstring_free( trace->path );
+    memory_free( trace, sizeof(*trace) );
+}
+
+static b32 path_walk_dir_internal(
+    DString** path, b32 recursive, b32 include_dirs,
+    usize* out_count, DString** out_buffer );
+static b32 path_walk_dir_shallow(
+    DString* dir, b32 include_dirs,
+    usize* out_count, DString** out_buffer, Darray(DString*)* out_subdirs );
+
+static struct JobBuffer* job_buffer_alloc( usize cap ) {
+    struct JobBuffer* buf =
+        memory_alloc( sizeof(*buf) + (sizeof(struct JobEntry) * cap) );
+    expect( buf, "failed to allocate job deque buffer!" );
+    buf->cap = cap;
+    return buf;
+}
+static void job_deque_push( struct JobDeque* deque, struct JobEntry entry ) {
+    i64 b = deque->bottom;
+    i64 t = deque->top;
+    struct JobBuffer* buf = deque->buf;
+
+    if( (b - t) >= (i64)buf->cap ) {
+        // deque is full, grow it.
+        // entries are copied so that index & (cap - 1)
+        // still finds them in the new buffer.
+        expect(
+            deque->retired_count < static_array_len( deque->retired ),
+            "job deque grew too many times!" );
+        struct JobBuffer* grown = job_buffer_alloc( buf->cap * 2 );
+        for( i64 i = t; i < b; ++i ) {
+            grown->entries[i & ((i64)grown->cap - 1)] =
+                buf->entries[i & ((i64)buf->cap - 1)];
+        }
+        deque->retired[deque->retired_count++] = buf;
+        fence();
+        deque->buf = grown;
+        buf        = grown;
     }
-    atomic_add( &queue->len, -1 );
 
+    buf->entries[b & ((i64)buf->cap - 1)] = entry;
+    fence();
+    deque->bottom = b + 1;
+}
+static b32 job_deque_pop( struct JobDeque* deque, struct JobEntry* out_entry ) {
+    i64 b = deque->bottom - 1;
+    deque->bottom = b;
     fence();
-    atom front = atomic_add( &queue->front, 1 );
+    i64 t = deque->top;
+
+    if( t > b ) {
+        // deque was empty.
+        deque->bottom = t;
+        return false;
+    }
+
+    struct JobBuffer* buf = deque->buf;
+    *out_entry = buf->entries[b & ((i64)buf->cap - 1)];
+    if( t == b ) {
+        // last entry, stealers might be racing for it.
+        b32 won = atomic_compare_swap64( &deque->top, t, t + 1 ) == t;
+        deque->bottom = t + 1;
+        return won;
+    }
+    return true;
+}
+static b32 job_deque_steal( struct JobDeque* deque, struct JobEntry* out_entry ) {
+    i64 t = deque->top;
     fence();
+    i64 b = deque->bottom;
+
+    if( t >= b ) {
+        return false;
+    }
 
-    *out_entry = queue->entries[ (front + 1) % CBUILD_MAX_JOBS ];
+    struct JobBuffer* buf   = deque->buf;
+    struct JobEntry   entry = buf->entries[t & ((i64)buf->cap - 1)];
+    if( atomic_compare_swap64( &deque->top, t, t + 1 ) != t ) {
+        // lost the race with owner or another stealer.
+        return false;
+    }
+    *out_entry = entry;
     return true;
 }
+static b32 job_dequeue( struct JobQueue* queue, struct JobEntry* out_entry ) {
+    u32 id = thread_id();
+    if( job_deque_pop( queue->deques + id, out_entry ) ) {
+        return true;
+    }
+    for( u32 i = 1; i < static_array_len( queue->deques ); ++i ) {
+        u32 victim = (id + i) % static_array_len( queue->deques );
+        if( job_deque_steal( queue->deques + victim, out_entry ) ) {
+            return true;
+        }
+    }
+    return false;
+}
 void job_queue_proc( void* params ) {
     struct JobQueue* queue = params;
     fence();
@@ -2012,23 +3613,33 @@ void job_queue_proc( void* params ) {
         struct JobEntry entry;
         memory_zero( &entry, sizeof(entry) );
 
-        semaphore_wait( &queue->wakeup );
-        fence();
-
-        if( job_dequeue( queue, &entry ) ) {
-            entry.proc( entry.params );
-            fence();
-            atomic_add( &queue->pending, -1 );
+        if( !job_dequeue( queue, &entry ) ) {
+            atom generation = event_prepare( &queue->wakeup );
+            // recheck, a job enqueued before the prepare
+            // already signaled and must not be slept through.
+            if( !job_dequeue( queue, &entry ) ) {
+                event_wait( &queue->wakeup, generation );
+                fence();
+                continue;
+            }
         }
+
+        trace_event_begin( "job" );
+        entry.proc( entry.params );
+        trace_event_end();
+        fence();
+        atomic_add( &queue->pending, -1 );
+        event_signal_all( &queue->complete );
     }
 }
 static void initialize_job_queue(void) {
     cb_info(
-        "creating job queue with %u entries and %u threads . . .",
-        CBUILD_MAX_JOBS, CBUILD_THREAD_COUNT );
+        "creating job scheduler with %u deques and %u threads . . .",
+        CBUILD_THREAD_COUNT + 1, CBUILD_THREAD_COUNT );
 
-    expect( mutex_create( &global_logger_mutex ), "failed to create logger mutex!" );
-    atomic_add( &global_is_mt, 1 );
+    initialize_mt();
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_JOB );
 
     usize queue_size       = sizeof(*global_queue);
     struct JobQueue* queue = memory_alloc( queue_size );
@@ -2036,9 +3647,14 @@ static void initialize_job_queue(void) {
     expect( queue, "failed to allocate job queue!" );
 
     expect(
-        semaphore_create( &queue->wakeup ),
-        "failed to create job queue semaphore!" );
-    queue->front = -1;
+        event_create( &queue->wakeup ) &&
+        event_create( &queue->complete ),
+        "failed to create job queue events!" );
+    for( usize i = 0; i < static_array_len( queue->deques ); ++i ) {
+        queue->deques[i].buf = job_buffer_alloc( CBUILD_MAX_JOBS );
+    }
+
+    memory_tag_leave( tag );
 
     fence();
 
@@ -2055,31 +3671,79 @@ static volatile struct JobQueue* get_job_queue(void) {
     }
     return global_queue;
 }
-static volatile struct LocalBuffers* get_local_buffers(void) {
-    if( !global_local_buffers ) {
-        global_local_buffers = memory_alloc( sizeof(*global_local_buffers) );
-        expect( global_local_buffers,
-            "failed to allocate local buffers! size: %zu",
-            sizeof(*global_local_buffers) );
+static struct ScratchBlock* scratch_block_alloc( usize cap ) {
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_SCRATCH );
+    struct ScratchBlock* block = memory_alloc( sizeof(*block) + cap );
+    memory_tag_leave( tag );
+    expect( block, "failed to allocate scratch block! size: %zu", cap );
+    block->cap = cap;
+    return block;
+}
+static struct Scratch* get_scratch(void) {
+    if( !global_scratch ) {
+        struct Scratch* scratch = memory_alloc( sizeof(*scratch) );
+        expect( scratch, "failed to allocate scratch arena!" );
+        scratch->first   = scratch_block_alloc( CBUILD_SCRATCH_BLOCK_SIZE );
+        scratch->current = scratch->first;
+        global_scratch   = scratch;
+    }
+    return global_scratch;
+}
+ScratchScope scratch_begin(void) {
+    struct Scratch* scratch = get_scratch();
+
+    ScratchScope scope;
+    scope.block = scratch->current;
+    scope.at    = scratch->at;
+
+    scratch->depth++;
+    return scope;
+}
+void scratch_end( ScratchScope scope ) {
+    struct Scratch* scratch = get_scratch();
+    assertion( scratch->depth, "scratch_end without matching scratch_begin!" );
+
+    scratch->depth--;
+    scratch->current = scope.block;
+    scratch->at      = scope.at;
+}
+void* scratch_alloc( usize size ) {
+    struct Scratch* scratch = get_scratch();
+    // align to pointer size, same as arena_alloc().
+    usize aligned = size + (sizeof(void*) - (size % sizeof(void*)));
+
+    if( !scratch->depth ) {
+        // no scope is open: recycle the first block once it fills
+        // up, like the old local buffer ring, instead of growing.
+        if(
+            scratch->current != scratch->first ||
+            (scratch->at + aligned) > scratch->first->cap
+        ) {
+            scratch->current = scratch->first;
+            scratch->at      = 0;
+        }
     }
-    return global_local_buffers;
-}
-static volatile char* get_next_local_buffer( u32 id ) {
-    volatile struct LocalBuffers* b = get_local_buffers();
 
-    u32 index = 0;
-    if( global_is_mt ) {
-        atom atomic = atomic_add( &b->indices[id], 1 );
-        index = (*(u32*)&atomic) % CBUILD_LOCAL_BUFFER_COUNT;
-    } else {
-        atom atomic     = b->indices[id];
-        b->indices[id] += 1;
-        index = (*(u32*)&atomic) % CBUILD_LOCAL_BUFFER_COUNT;
+    if( (scratch->at + aligned) > scratch->current->cap ) {
+        struct ScratchBlock* next = scratch->current->next;
+        if( !next || next->cap < aligned ) {
+            usize cap = CBUILD_SCRATCH_BLOCK_SIZE;
+            if( cap < aligned ) {
+                cap = aligned;
+            }
+            next       = scratch_block_alloc( cap );
+            next->next = scratch->current->next;
+
+            scratch->current->next = next;
+        }
+        scratch->current = next;
+        scratch->at      = 0;
     }
 
-    volatile char* result = b->buffers[id][index];
-    memory_zero( (void*)result, CBUILD_LOCAL_BUFFER_CAPACITY );
-    return result;
+    void* res    = scratch->current->buf + scratch->at;
+    scratch->at += aligned;
+    memory_zero( res, size );
+    return res;
 }
 static volatile struct GlobalBuffers* get_global_buffers(void) {
     if( !global_buffers.obtained ) {
@@ -2168,7 +3832,7 @@ void _init_(
     global_command_line.count = argc;
     global_command_line.args  = heap_args;
 
-    (void)get_local_buffers();
+    (void)get_scratch();
     (void)get_global_buffers();
 
     expect( path_exists( __FILE__ ),
@@ -2314,12 +3978,114 @@ does_not_return() void cbuild_rebuild(
 #endif
 }
 
+static void memory_peak_update( atom64* peak, i64 current ) {
+    // only pays a compare-swap when a new high is set.
+    i64 previous = *peak;
+    while( current > previous ) {
+        i64 swapped = atomic_compare_swap64( peak, previous, current );
+        if( swapped == previous ) {
+            break;
+        }
+        previous = swapped;
+    }
+}
+static void memory_track_alloc( usize size ) {
+    MemoryTag tag = global_memory_tag;
+    if( global_is_mt ) {
+        i64 usage = atomic_add64( &global_memory_usage, size ) + (i64)size;
+        atomic_add64( &global_total_memory_usage, size );
+        i64 tag_usage =
+            atomic_add64( global_memory_tag_usage + tag, size ) + (i64)size;
+        memory_peak_update( &global_memory_peak, usage );
+        memory_peak_update( global_memory_tag_peak + tag, tag_usage );
+    } else {
+        global_memory_usage           += size;
+        global_total_memory_usage     += size;
+        global_memory_tag_usage[tag]  += size;
+        if( global_memory_usage > global_memory_peak ) {
+            global_memory_peak = global_memory_usage;
+        }
+        if( global_memory_tag_usage[tag] > global_memory_tag_peak[tag] ) {
+            global_memory_tag_peak[tag] = global_memory_tag_usage[tag];
+        }
+    }
+}
+static void memory_track_free( usize size ) {
+    MemoryTag tag = global_memory_tag;
+    atom64 neg = size;
+    neg = -neg;
+    if( global_is_mt ) {
+        atomic_add64( &global_memory_usage, neg );
+        atomic_add64( global_memory_tag_usage + tag, neg );
+    } else {
+        global_memory_usage          += neg;
+        global_memory_tag_usage[tag] += neg;
+    }
+}
 usize memory_query_usage(void) {
     return global_memory_usage;
 }
 usize memory_query_total_usage(void) {
     return global_total_memory_usage;
 }
+usize memory_query_peak_usage(void) {
+    return global_memory_peak;
+}
+MemoryTag memory_tag_set( MemoryTag tag ) {
+    assertion( tag < MEMORY_TAG_COUNT, "invalid memory tag!" );
+    MemoryTag previous = global_memory_tag;
+    global_memory_tag  = tag;
+    return previous;
+}
+const char* memory_tag_name( MemoryTag tag ) {
+    switch( tag ) {
+        case MEMORY_TAG_GENERAL: return "general";
+        case MEMORY_TAG_DARRAY:  return "darray";
+        case MEMORY_TAG_DSTRING: return "dstring";
+        case MEMORY_TAG_SCRATCH: return "scratch";
+        case MEMORY_TAG_JOB:     return "job";
+        case MEMORY_TAG_WALK:    return "walk";
+        case MEMORY_TAG_PROCESS: return "process";
+        case MEMORY_TAG_CACHE:   return "cache";
+        default:                 return "unknown";
+    }
+}
+usize memory_query_tag_usage( MemoryTag tag ) {
+    assertion( tag < MEMORY_TAG_COUNT, "invalid memory tag!" );
+    return global_memory_tag_usage[tag];
+}
+usize memory_query_tag_peak( MemoryTag tag ) {
+    assertion( tag < MEMORY_TAG_COUNT, "invalid memory tag!" );
+    return global_memory_tag_peak[tag];
+}
+static void memory_usage_report(void) {
+    cb_info(
+        "memory: peak %zu bytes, %zu bytes allocated in total.",
+        (usize)global_memory_peak, (usize)global_total_memory_usage );
+    for( MemoryTag tag = MEMORY_TAG_GENERAL; tag < MEMORY_TAG_COUNT; ++tag ) {
+        if( !global_memory_tag_peak[tag] ) {
+            continue;
+        }
+        // current is signed, cross-tag frees can drive it negative.
+        cb_info(
+            "memory: %-8s current %10lli peak %10zu",
+            memory_tag_name( tag ),
+            (long long)global_memory_tag_usage[tag],
+            (usize)global_memory_tag_peak[tag] );
+    }
+    if( global_memory_usage ) {
+        cb_warn(
+            "memory: %zu bytes still allocated at exit!",
+            (usize)global_memory_usage );
+    }
+}
+void memory_enable_usage_report(void) {
+    static b32 enabled = false;
+    if( !enabled ) {
+        enabled = true;
+        atexit( memory_usage_report );
+    }
+}
 void memory_set( void* memory, i8 value, usize size ) {
     memset( memory, value, size );
 }
@@ -2348,6 +4114,80 @@ b32 memory_cmp( const void* a, const void* b, usize size ) {
     return memcmp( a, b, size ) == 0;
 }
 
+b32 arena_create( usize cap, Arena* out_arena ) {
+    assertion( cap, "arena capacity must be >= 1!" );
+    assertion( out_arena, "no arena provided!" );
+
+    memory_zero( out_arena, sizeof(*out_arena) );
+    out_arena->buf = memory_alloc( cap );
+    if( !out_arena->buf ) {
+        return false;
+    }
+    out_arena->cap = cap;
+    return true;
+}
+void* arena_alloc( Arena* arena, usize size ) {
+    assertion( arena && arena->buf, "arena is null!" );
+
+    // keep allocations pointer-aligned.
+    usize aligned = size + (sizeof(void*) - (size % sizeof(void*)));
+    if( arena->at + aligned > arena->cap ) {
+        return NULL;
+    }
+
+    void* res  = arena->buf + arena->at;
+    arena->at += aligned;
+    return res;
+}
+void arena_reset( Arena* arena ) {
+    assertion( arena && arena->buf, "arena is null!" );
+    memory_zero( arena->buf, arena->at );
+    arena->at = 0;
+}
+void arena_destroy( Arena* arena ) {
+    if( arena ) {
+        if( arena->buf ) {
+            memory_free( arena->buf, arena->cap );
+        }
+        memory_zero( arena, sizeof(*arena) );
+    }
+}
+
+#if defined(CBUILD_SIMD_SSE2)
+static u32 internal_mask_first( u32 mask ) {
+    // mask must not be zero.
+#if defined(COMPILER_MSVC)
+    unsigned long index = 0;
+    _BitScanForward( &index, mask );
+    return index;
+#else
+    return __builtin_ctz( mask );
+#endif
+}
+static u32 internal_mask_last( u32 mask ) {
+    // mask must not be zero.
+#if defined(COMPILER_MSVC)
+    unsigned long index = 0;
+    _BitScanReverse( &index, mask );
+    return index;
+#else
+    return 31 - __builtin_clz( mask );
+#endif
+}
+#elif defined(CBUILD_SIMD_NEON)
+// 4 bits per byte, bit index / 4 gives byte index.
+static u64 internal_neon_mask( uint8x16_t cmp ) {
+    uint8x8_t nib = vshrn_n_u16( vreinterpretq_u16_u8( cmp ), 4 );
+    return vget_lane_u64( vreinterpret_u64_u8( nib ), 0 );
+}
+static u32 internal_mask_first( u64 mask ) {
+    return (u32)(__builtin_ctzll( mask ) >> 2);
+}
+static u32 internal_mask_last( u64 mask ) {
+    return (u32)((63 - __builtin_clzll( mask )) >> 2);
+}
+#endif
+
 b32 char_in_set( char c, String set ) {
     for( usize i = 0; i < set.len; ++i ) {
         if( c == set.cc[i] ) {
@@ -2390,7 +4230,36 @@ b32 string_find( String str, char c, usize* opt_out_index ) {
     return true;
 }
 b32 string_find_rev( String str, char c, usize* opt_out_index ) {
-    for( usize i = str.len; i-- > 0; ) {
+    usize i = str.len;
+#if defined(CBUILD_SIMD_SSE2)
+    const __m128i needle = _mm_set1_epi8( c );
+    while( i >= 16 ) {
+        i -= 16;
+        __m128i block =
+            _mm_loadu_si128( (const __m128i*)(str.cc + i) );
+        u32 mask = _mm_movemask_epi8( _mm_cmpeq_epi8( block, needle ) );
+        if( mask ) {
+            if( opt_out_index ) {
+                *opt_out_index = i + internal_mask_last( mask );
+            }
+            return true;
+        }
+    }
+#elif defined(CBUILD_SIMD_NEON)
+    const uint8x16_t needle = vdupq_n_u8( (u8)c );
+    while( i >= 16 ) {
+        i -= 16;
+        uint8x16_t block = vld1q_u8( (const u8*)(str.cc + i) );
+        u64 mask = internal_neon_mask( vceqq_u8( block, needle ) );
+        if( mask ) {
+            if( opt_out_index ) {
+                *opt_out_index = i + internal_mask_last( mask );
+            }
+            return true;
+        }
+    }
+#endif
+    while( i-- > 0 ) {
         if( str.cc[i] == c ) {
             if( opt_out_index ) {
                 *opt_out_index = i;
@@ -2401,15 +4270,92 @@ b32 string_find_rev( String str, char c, usize* opt_out_index ) {
     return false;
 }
 b32 string_find_set( String str, String set, usize* opt_out_index ) {
-    for( usize i = 0; i < set.len; ++i ) {
-        if( string_find( str, set.cc[i], opt_out_index ) ) {
+    usize i = 0;
+#if defined(CBUILD_SIMD_SSE2)
+    while( i + 16 <= str.len ) {
+        __m128i block =
+            _mm_loadu_si128( (const __m128i*)(str.cc + i) );
+        __m128i eq = _mm_setzero_si128();
+        for( usize s = 0; s < set.len; ++s ) {
+            eq = _mm_or_si128(
+                eq, _mm_cmpeq_epi8( block, _mm_set1_epi8( set.cc[s] ) ) );
+        }
+        u32 mask = _mm_movemask_epi8( eq );
+        if( mask ) {
+            if( opt_out_index ) {
+                *opt_out_index = i + internal_mask_first( mask );
+            }
+            return true;
+        }
+        i += 16;
+    }
+#elif defined(CBUILD_SIMD_NEON)
+    while( i + 16 <= str.len ) {
+        uint8x16_t block = vld1q_u8( (const u8*)(str.cc + i) );
+        uint8x16_t eq    = vdupq_n_u8( 0 );
+        for( usize s = 0; s < set.len; ++s ) {
+            eq = vorrq_u8(
+                eq, vceqq_u8( block, vdupq_n_u8( (u8)set.cc[s] ) ) );
+        }
+        u64 mask = internal_neon_mask( eq );
+        if( mask ) {
+            if( opt_out_index ) {
+                *opt_out_index = i + internal_mask_first( mask );
+            }
+            return true;
+        }
+        i += 16;
+    }
+#endif
+    for( ; i < str.len; ++i ) {
+        if( char_in_set( str.cc[i], set ) ) {
+            if( opt_out_index ) {
+                *opt_out_index = i;
+            }
             return true;
         }
     }
     return false;
 }
 b32 string_find_set_rev( String str, String set, usize* opt_out_index ) {
-    for( usize i = str.len; i-- > 0; ) {
+    usize i = str.len;
+#if defined(CBUILD_SIMD_SSE2)
+    while( i >= 16 ) {
+        i -= 16;
+        __m128i block =
+            _mm_loadu_si128( (const __m128i*)(str.cc + i) );
+        __m128i eq = _mm_setzero_si128();
+        for( usize s = 0; s < set.len; ++s ) {
+            eq = _mm_or_si128(
+                eq, _mm_cmpeq_epi8( block, _mm_set1_epi8( set.cc[s] ) ) );
+        }
+        u32 mask = _mm_movemask_epi8( eq );
+        if( mask ) {
+            if( opt_out_index ) {
+                *opt_out_index = i + internal_mask_last( mask );
+            }
+            return true;
+        }
+    }
+#elif defined(CBUILD_SIMD_NEON)
+    while( i >= 16 ) {
+        i -= 16;
+        uint8x16_t block = vld1q_u8( (const u8*)(str.cc + i) );
+        uint8x16_t eq    = vdupq_n_u8( 0 );
+        for( usize s = 0; s < set.len; ++s ) {
+            eq = vorrq_u8(
+                eq, vceqq_u8( block, vdupq_n_u8( (u8)set.cc[s] ) ) );
+        }
+        u64 mask = internal_neon_mask( eq );
+        if( mask ) {
+            if( opt_out_index ) {
+                *opt_out_index = i + internal_mask_last( mask );
+            }
+            return true;
+        }
+    }
+#endif
+    while( i-- > 0 ) {
         if( char_in_set( str.cc[i], set ) ) {
             if( opt_out_index ) {
                 *opt_out_index = i;
@@ -2420,28 +4366,76 @@ b32 string_find_set_rev( String str, String set, usize* opt_out_index ) {
     return false;
 }
 b32 string_find_string( String str, String substr, usize* opt_out_index ) {
-    String rem = str;
-    if( rem.len < substr.len ) {
+    if( str.len < substr.len || !substr.len ) {
         return false;
     }
-
-    while( rem.len ) {
-        usize start = 0;
-        if( string_find( rem, substr.cc[0], &start ) ) {
-            rem = string_advance_by( rem, start );
-            if( rem.len < substr.len ) {
-                return false;
+    if( substr.len == 1 ) {
+        return string_find( str, substr.cc[0], opt_out_index );
+    }
+
+    // candidate start positions.
+    usize end = (str.len - substr.len) + 1;
+    usize i   = 0;
+#if defined(CBUILD_SIMD_SSE2)
+    // scan for positions where both first and last
+    // byte of substr line up, then verify candidates.
+    const __m128i first = _mm_set1_epi8( substr.cc[0] );
+    const __m128i last  = _mm_set1_epi8( substr.cc[substr.len - 1] );
+    while( i + 16 <= end ) {
+        __m128i block_first =
+            _mm_loadu_si128( (const __m128i*)(str.cc + i) );
+        __m128i block_last  =
+            _mm_loadu_si128(
+                (const __m128i*)(str.cc + i + (substr.len - 1)) );
+        u32 mask = _mm_movemask_epi8(
+            _mm_and_si128(
+                _mm_cmpeq_epi8( block_first, first ),
+                _mm_cmpeq_epi8( block_last, last ) ) );
+        while( mask ) {
+            u32 bit = internal_mask_first( mask );
+            if( memory_cmp( str.cc + i + bit, substr.cc, substr.len ) ) {
+                if( opt_out_index ) {
+                    *opt_out_index = i + bit;
+                }
+                return true;
             }
-
-            if( string_cmp( string_truncate(rem, substr.len), substr ) ) {
+            mask &= mask - 1;
+        }
+        i += 16;
+    }
+#elif defined(CBUILD_SIMD_NEON)
+    const uint8x16_t first = vdupq_n_u8( (u8)substr.cc[0] );
+    const uint8x16_t last  = vdupq_n_u8( (u8)substr.cc[substr.len - 1] );
+    while( i + 16 <= end ) {
+        uint8x16_t block_first = vld1q_u8( (const u8*)(str.cc + i) );
+        uint8x16_t block_last  =
+            vld1q_u8( (const u8*)(str.cc + i + (substr.len - 1)) );
+        u64 mask = internal_neon_mask(
+            vandq_u8(
+                vceqq_u8( block_first, first ),
+                vceqq_u8( block_last, last ) ) );
+        while( mask ) {
+            u32 bit = internal_mask_first( mask );
+            if( memory_cmp( str.cc + i + bit, substr.cc, substr.len ) ) {
                 if( opt_out_index ) {
-                    *opt_out_index = rem.cc - str.cc;
+                    *opt_out_index = i + bit;
                 }
                 return true;
             }
-            rem = string_advance( rem );
-        } else {
-            break;
+            mask &= ~( 0xFull << ((u64)bit * 4) );
+        }
+        i += 16;
+    }
+#endif
+    for( ; i < end; ++i ) {
+        if(
+            str.cc[i] == substr.cc[0] &&
+            memory_cmp( str.cc + i, substr.cc, substr.len )
+        ) {
+            if( opt_out_index ) {
+                *opt_out_index = i;
+            }
+            return true;
         }
     }
     return false;
@@ -2552,62 +4546,55 @@ b32 string_split_char(
     string_split_at( src, at, keep_split, opt_out_left, opt_out_right );
     return true;
 }
-String* string_split_delim( String src, String delim, b32 keep_delim ) {
-    usize  count  = 0;
-    String substr = src;
-    while( substr.len ) {
-        usize pos = 0;
-        if( string_find_string( substr, delim, &pos ) ) {
-            count++;
-            substr = string_advance_by( substr, pos + delim.len );
-        } else {
-            count++;
-            break;
-        }
-    }
-
-    String* res = (String*)darray_empty( sizeof(String), count );
-    expect( res, "failed to allocate string buffer!" );
+StringSplitIter string_split_iter( String src, String delim, b32 keep_delim ) {
+    assertion( delim.len, "empty delimiter provided!" );
 
-    if( count == 1 ) {
-        return (String*)darray_push( res, &src );
+    StringSplitIter iter;
+    memory_zero( &iter, sizeof(iter) );
+    iter.rem        = src;
+    iter.delim      = delim;
+    iter.keep_delim = keep_delim;
+    iter.done       = src.len == 0;
+    return iter;
+}
+b32 string_split_next( StringSplitIter* iter, String* out_split ) {
+    assertion( iter && out_split, "no iterator or out pointer provided!" );
+    if( iter->done ) {
+        return false;
     }
 
-    substr = src;
-    if( keep_delim ) {
-        while( substr.len ) {
-            usize pos = 0;
-            if( string_find_string( substr, delim, &pos ) ) {
-                String chunk = substr;
-                chunk.len = pos + delim.len;
-
-                expect( darray_try_push( res, &chunk ),
-                    "misallocated result!" );
+    usize pos = 0;
+    if( string_find_string( iter->rem, iter->delim, &pos ) ) {
+        String chunk = iter->rem;
+        chunk.len    = iter->keep_delim ? pos + iter->delim.len : pos;
+        *out_split   = chunk;
 
-                substr = string_advance_by( substr, chunk.len );
-            } else {
-                expect( darray_try_push( res, &substr ),
-                    "misallocated result!" );
-                break;
-            }
+        iter->rem = string_advance_by( iter->rem, pos + iter->delim.len );
+        if( !iter->rem.len ) {
+            iter->done = true;
         }
-    } else {
-        while( substr.len ) {
-            usize pos = 0;
-            if( string_find_string( substr, delim, &pos ) ) {
-                String chunk = substr;
-                chunk.len    = pos;
+        return true;
+    }
 
-                expect( darray_try_push( res, &chunk ),
-                    "misallocated result!" );
+    *out_split = iter->rem;
+    iter->rem  = string_advance_by( iter->rem, iter->rem.len );
+    iter->done = true;
+    return true;
+}
+String* string_split_delim( String src, String delim, b32 keep_delim ) {
+    usize count = 0;
+    String chunk;
+    StringSplitIter iter = string_split_iter( src, delim, keep_delim );
+    while( string_split_next( &iter, &chunk ) ) {
+        count++;
+    }
 
-                substr = string_advance_by( substr, chunk.len + delim.len );
-            } else {
-                expect( darray_try_push( res, &substr ),
-                    "misallocated result!" );
-                break;
-            }
-        }
+    String* res = (String*)darray_empty( sizeof(String), count );
+    expect( res, "failed to allocate string buffer!" );
+
+    iter = string_split_iter( src, delim, keep_delim );
+    while( string_split_next( &iter, &chunk ) ) {
+        expect( darray_try_push( res, &chunk ), "misallocated result!" );
     }
 
     return res;
@@ -2618,90 +4605,29 @@ String* string_split_delim_ex(
 ) {
     expect( filter, "no filter function provided!" );
 
-    usize  count  = 0;
-    String substr = src;
-    while( substr.len ) {
-        usize pos = 0;
-        if( string_find_string( substr, delim, &pos ) ) {
-            count++;
-            substr = string_advance_by( substr, pos + delim.len );
-        } else {
-            count++;
-            break;
-        }
+    usize count = 0;
+    String chunk;
+    StringSplitIter iter = string_split_iter( src, delim, keep_delim );
+    while( string_split_next( &iter, &chunk ) ) {
+        count++;
     }
 
     String* res = (String*)darray_empty( sizeof(String), count );
     expect( res, "failed to allocate string buffer!" );
 
-    if( count == 1 ) {
-        String filtered = filter( 0, src, params );
+    usize index = 0;
+    iter = string_split_iter( src, delim, keep_delim );
+    while( string_split_next( &iter, &chunk ) ) {
+        String filtered = filter( index, chunk, params );
         if( filtered.len ) {
             expect( darray_try_push( res, &filtered ),
                 "misallocated result!" );
+            index++;
         }
-        return res;
     }
 
-    usize index = 0;
-    substr = src;
-    if( keep_delim ) {
-        while( substr.len ) {
-            usize pos = 0;
-            if( string_find_string( substr, delim, &pos ) ) {
-                String chunk = substr;
-                chunk.len    = pos + delim.len;
-
-                chunk = filter( index, chunk, params );
-
-                if( chunk.len ) {
-                    expect( darray_try_push( res, &chunk ),
-                        "misallocated result!" );
-                    index++;
-                }
-
-                substr = string_advance_by( substr, chunk.len );
-            } else {
-                String filtered = filter( index++, substr, params );
-
-                if( filtered.len ) {
-                    expect( darray_try_push( res, &filtered ),
-                        "misallocated result!" );
-                }
-                break;
-            }
-        }
-    } else {
-        while( substr.len ) {
-            usize pos = 0;
-            if( string_find_string( substr, delim, &pos ) ) {
-                String chunk = substr;
-                chunk.len    = pos;
-
-                chunk = filter( index, chunk, params );
-
-                if( chunk.len ) {
-                    expect( darray_try_push( res, &chunk ),
-                        "misallocated result!" );
-                    index++;
-                }
-
-                substr = string_advance_by( substr, chunk.len + delim.len );
-            } else {
-                String filtered = filter( index++, substr, params );
-
-                if( filtered.len ) {
-                    expect( darray_try_push( res, &filtered ),
-                        "misallocated result!" );
-                }
-                break;
-            }
-        }
-    }
-
-    return res;
-
-}
+    return res;
+}
 
 usize string_len_utf8( String str ) {
     const unsigned char* ucc = (const unsigned char*)str.cc;
@@ -2714,16 +4640,29 @@ usize string_len_utf8( String str ) {
     return res;
 }
 
-DString* dstring_empty( usize cap ) {
+DString* dstring_empty_arena( Arena* opt_arena, usize cap ) {
     usize capacity = cap ? cap : 1;
-    struct DynamicString* res =
-        (struct DynamicString*)memory_alloc( sizeof(*res) + capacity );
-    res->cap = capacity;
+    usize size     = sizeof(struct DynamicString) + capacity;
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_DSTRING );
+    struct DynamicString* res = opt_arena
+        ? (struct DynamicString*)arena_alloc( opt_arena, size )
+        : (struct DynamicString*)memory_alloc( size );
+    memory_tag_leave( tag );
+    if( !res ) {
+        return NULL;
+    }
+    res->cap   = capacity;
+    res->arena = opt_arena;
     return res->buf;
 }
-DString* dstring_new( usize len, const char* str ) {
-    struct DynamicString* res = 
-        (struct DynamicString*)dstring_head( dstring_empty( len + 1 ) );
+DString* dstring_empty( usize cap ) {
+    return dstring_empty_arena( NULL, cap );
+}
+DString* dstring_new_arena( Arena* opt_arena, usize len, const char* str ) {
+    struct DynamicString* res =
+        (struct DynamicString*)dstring_head(
+            dstring_empty_arena( opt_arena, len + 1 ) );
     if( !res ) {
         return NULL;
     }
@@ -2731,22 +4670,375 @@ DString* dstring_new( usize len, const char* str ) {
     res->len = len;
     return res->buf;
 }
-DString* dstring_fmt_va( const char* format, va_list va ) {
-    va_list va2;
-    va_copy( va2, va );
+DString* dstring_new( usize len, const char* str ) {
+    return dstring_new_arena( NULL, len, str );
+}
+// NOTE(alicia): single-pass formatting core shared by dstring_fmt()
+// and local_fmt(). The specifiers cbuild itself leans on (%s, %c,
+// signed/unsigned/hex integers with length modifiers, %.*s, %p, %%)
+// are formatted natively with no measuring pass, anything exotic is
+// punted to libc snprintf one specifier at a time.
+
+struct FmtDst {
+    DString** dstr; // grows geometrically when non-null.
+    char*     buf;  // fixed buffer otherwise, output clamped to cap.
+    usize     cap;
+    usize     len;
+    b32       failed;
+};
+struct FmtSpec {
+    usize len;       // characters consumed including '%'.
+    char  conv;      // conversion character.
+    int   width;     // -1 none, -2 from argument.
+    int   precision; // -1 none, -2 from argument.
+    int   size;      // 0 int, 1 long, 2 long long, 3 long double, 4 size.
+    b32   left, plus, space, hash, zero;
+};
+static void fmt_emit( struct FmtDst* dst, usize len, const char* bytes ) {
+    if( !len ) {
+        return;
+    }
+    if( dst->dstr ) {
+        struct DynamicString* head = dstring_head( *dst->dstr );
+        if( (head->cap - head->len) <= len ) {
+            usize amount = head->cap;
+            if( amount <= len ) {
+                amount = len + 1;
+            }
+            DString* grown = dstring_grow( *dst->dstr, amount );
+            if( !grown ) {
+                dst->failed = true;
+                return;
+            }
+            *dst->dstr = grown;
+            head       = dstring_head( grown );
+        }
+        memory_copy( head->buf + head->len, bytes, len );
+        head->len += len;
+        return;
+    }
+    usize rem = dst->cap - dst->len;
+    if( len > rem ) {
+        len = rem;
+    }
+    memory_copy( dst->buf + dst->len, bytes, len );
+    dst->len += len;
+}
+static void fmt_emit_pad( struct FmtDst* dst, usize count, char pad ) {
+    char chunk[16];
+    memory_set( chunk, pad, sizeof(chunk) );
+    while( count ) {
+        usize n = count > sizeof(chunk) ? sizeof(chunk) : count;
+        fmt_emit( dst, n, chunk );
+        count -= n;
+    }
+}
+// emit body applying field width. first sign_len bytes stay in
+// front of any zero padding.
+static void fmt_emit_field(
+    struct FmtDst* dst, const struct FmtSpec* spec,
+    usize sign_len, usize len, const char* body
+) {
+    usize width = spec->width > 0 ? (usize)spec->width : 0;
+    if( width <= len ) {
+        fmt_emit( dst, len, body );
+        return;
+    }
+    usize pad = width - len;
+    if( spec->left ) {
+        fmt_emit( dst, len, body );
+        fmt_emit_pad( dst, pad, ' ' );
+    } else if( spec->zero ) {
+        fmt_emit( dst, sign_len, body );
+        fmt_emit_pad( dst, pad, '0' );
+        fmt_emit( dst, len - sign_len, body + sign_len );
+    } else {
+        fmt_emit_pad( dst, pad, ' ' );
+        fmt_emit( dst, len, body );
+    }
+}
+static usize fmt_u64_digits( u64 value, u32 base, b32 upper, char* out ) {
+    const char* digits =
+        upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char  tmp[24];
+    usize n = 0;
+    do {
+        tmp[n++] = digits[value % base];
+        value   /= base;
+    } while( value );
+    for( usize i = 0; i < n; ++i ) {
+        out[i] = tmp[n - 1 - i];
+    }
+    return n;
+}
+static b32 fmt_parse_spec( const char* at, struct FmtSpec* out_spec ) {
+    const char* start = at++; // start points at '%'.
+    memory_zero( out_spec, sizeof(*out_spec) );
+    out_spec->width     = -1;
+    out_spec->precision = -1;
+
+    b32 parsing_flags = true;
+    while( parsing_flags ) {
+        switch( *at ) {
+            case '-': out_spec->left  = true; at++; break;
+            case '+': out_spec->plus  = true; at++; break;
+            case ' ': out_spec->space = true; at++; break;
+            case '#': out_spec->hash  = true; at++; break;
+            case '0': out_spec->zero  = true; at++; break;
+            default:  parsing_flags   = false; break;
+        }
+    }
+    if( *at == '*' ) {
+        out_spec->width = -2;
+        at++;
+    } else while( *at >= '0' && *at <= '9' ) {
+        if( out_spec->width < 0 ) {
+            out_spec->width = 0;
+        }
+        out_spec->width = (out_spec->width * 10) + (*at++ - '0');
+    }
+    if( *at == '.' ) {
+        at++;
+        out_spec->precision = 0;
+        if( *at == '*' ) {
+            out_spec->precision = -2;
+            at++;
+        } else while( *at >= '0' && *at <= '9' ) {
+            out_spec->precision = (out_spec->precision * 10) + (*at++ - '0');
+        }
+    }
+    switch( *at ) {
+        case 'h': {
+            at++;
+            if( *at == 'h' ) {
+                at++;
+            }
+        } break;
+        case 'l': {
+            at++;
+            out_spec->size = 1;
+            if( *at == 'l' ) {
+                at++;
+                out_spec->size = 2;
+            }
+        } break;
+        case 'j': {
+            at++;
+            out_spec->size = 2;
+        } break;
+        case 'z': case 't': {
+            // NOTE(alicia): size_t/ptrdiff_t are 4-byte varargs on
+            // 32-bit targets, reading i64/u64 would misalign the list.
+            at++;
+            out_spec->size = 4;
+        } break;
+        case 'L': {
+            at++;
+            out_spec->size = 3;
+        } break;
+    }
+    if( !*at ) {
+        return false;
+    }
+    out_spec->conv = *at;
+    out_spec->len  = (usize)(at + 1 - start);
+    return true;
+}
+// rebuild a concrete libc spec for the snprintf fallback,
+// star width/precision were already pulled off the va list.
+static void fmt_rebuild_spec(
+    const struct FmtSpec* spec, const char* length_mod, char* out
+) {
+    usize at = 0;
+    out[at++] = '%';
+    if( spec->left )  { out[at++] = '-'; }
+    if( spec->plus )  { out[at++] = '+'; }
+    if( spec->space ) { out[at++] = ' '; }
+    if( spec->hash )  { out[at++] = '#'; }
+    if( spec->zero )  { out[at++] = '0'; }
+    if( spec->width > 0 ) {
+        at += fmt_u64_digits( (u64)spec->width, 10, false, out + at );
+    }
+    if( spec->precision >= 0 ) {
+        out[at++] = '.';
+        at += fmt_u64_digits( (u64)spec->precision, 10, false, out + at );
+    }
+    while( *length_mod ) {
+        out[at++] = *length_mod++;
+    }
+    out[at++] = spec->conv;
+    out[at]   = 0;
+}
+static void fmt_emit_snprintf_result( struct FmtDst* dst, int n, usize cap, const char* tmp ) {
+    if( n <= 0 ) {
+        return;
+    }
+    usize len = (usize)n;
+    if( len >= cap ) {
+        len = cap - 1;
+    }
+    fmt_emit( dst, len, tmp );
+}
+static void fmt_core_va( struct FmtDst* dst, const char* format, va_list va ) {
+    const char* at  = format;
+    const char* run = at;
+
+    while( *at ) {
+        if( *at != '%' ) {
+            at++;
+            continue;
+        }
+        fmt_emit( dst, (usize)(at - run), run );
+
+        struct FmtSpec spec;
+        if( !fmt_parse_spec( at, &spec ) ) {
+            // format ends inside a specifier, emit it literally.
+            run = at;
+            at += strlen( at );
+            break;
+        }
+        if( spec.width == -2 ) {
+            int width = va_arg( va, int );
+            if( width < 0 ) {
+                spec.left = true;
+                width     = -width;
+            }
+            spec.width = width;
+        }
+        if( spec.precision == -2 ) {
+            int precision  = va_arg( va, int );
+            spec.precision = precision < 0 ? -1 : precision;
+        }
+
+        switch( spec.conv ) {
+            case '%': {
+                fmt_emit( dst, 1, "%" );
+            } break;
+            case 'c': {
+                char c = (char)va_arg( va, int );
+                fmt_emit_field( dst, &spec, 0, 1, &c );
+            } break;
+            case 's': {
+                const char* s = va_arg( va, const char* );
+                if( !s ) {
+                    s = "(null)";
+                }
+                usize len = 0;
+                if( spec.precision >= 0 ) {
+                    // precision-limited strings may not be
+                    // null-terminated, never read past it.
+                    while( len < (usize)spec.precision && s[len] ) {
+                        len++;
+                    }
+                } else {
+                    len = strlen( s );
+                }
+                fmt_emit_field( dst, &spec, 0, len, s );
+            } break;
+            case 'd': case 'i': {
+                i64 value;
+                switch( spec.size ) {
+                    case 1:  value = va_arg( va, long );  break;
+                    case 2:  value = va_arg( va, i64 );   break;
+                    case 4:  value = va_arg( va, isize ); break;
+                    default: value = va_arg( va, int );   break;
+                }
+                if( spec.plus || spec.space || spec.precision >= 0 ) {
+                    char spec_buf[32], tmp[32];
+                    fmt_rebuild_spec( &spec, "ll", spec_buf );
+                    int n = snprintf(
+                        tmp, sizeof(tmp), spec_buf, (long long)value );
+                    fmt_emit_snprintf_result( dst, n, sizeof(tmp), tmp );
+                    break;
+                }
+                char  body[24];
+                usize sign_len = 0;
+                u64   mag      = (u64)value;
+                if( value < 0 ) {
+                    body[sign_len++] = '-';
+                    mag = ((u64)-(value + 1)) + 1;
+                }
+                usize len = sign_len +
+                    fmt_u64_digits( mag, 10, false, body + sign_len );
+                fmt_emit_field( dst, &spec, sign_len, len, body );
+            } break;
+            case 'u': case 'x': case 'X': {
+                u64 value;
+                switch( spec.size ) {
+                    case 1:  value = va_arg( va, unsigned long ); break;
+                    case 2:  value = va_arg( va, u64 );           break;
+                    case 4:  value = va_arg( va, usize );         break;
+                    default: value = va_arg( va, unsigned int );  break;
+                }
+                if( spec.hash || spec.precision >= 0 ) {
+                    char spec_buf[32], tmp[32];
+                    fmt_rebuild_spec( &spec, "ll", spec_buf );
+                    int n = snprintf(
+                        tmp, sizeof(tmp), spec_buf,
+                        (unsigned long long)value );
+                    fmt_emit_snprintf_result( dst, n, sizeof(tmp), tmp );
+                    break;
+                }
+                char  body[24];
+                usize len = fmt_u64_digits(
+                    value, spec.conv == 'u' ? 10 : 16,
+                    spec.conv == 'X', body );
+                fmt_emit_field( dst, &spec, 0, len, body );
+            } break;
+            case 'p': {
+                char  body[24];
+                body[0] = '0';
+                body[1] = 'x';
+                usize len = 2 + fmt_u64_digits(
+                    (u64)(usize)va_arg( va, void* ), 16, false, body + 2 );
+                fmt_emit_field( dst, &spec, 0, len, body );
+            } break;
+            case 'f': case 'F': case 'e': case 'E':
+            case 'g': case 'G': case 'a': case 'A': {
+                if( spec.size == 3 ) {
+                    // long double, not worth supporting natively.
+                    char spec_buf[32], tmp[352];
+                    fmt_rebuild_spec( &spec, "L", spec_buf );
+                    int n = snprintf(
+                        tmp, sizeof(tmp), spec_buf,
+                        va_arg( va, long double ) );
+                    fmt_emit_snprintf_result( dst, n, sizeof(tmp), tmp );
+                    break;
+                }
+                char spec_buf[32], tmp[352];
+                fmt_rebuild_spec( &spec, "", spec_buf );
+                int n = snprintf(
+                    tmp, sizeof(tmp), spec_buf, va_arg( va, double ) );
+                fmt_emit_snprintf_result( dst, n, sizeof(tmp), tmp );
+            } break;
+            default: {
+                // unknown conversion, emit the specifier literally.
+                fmt_emit( dst, spec.len, at );
+            } break;
+        }
 
-    int msg_len = vsnprintf( 0, 0, format, va2 );
-    va_end( va2 );
+        at += spec.len;
+        run = at;
+    }
+    fmt_emit( dst, (usize)(at - run), run );
+}
 
-    struct DynamicString* res = dstring_head( dstring_empty( msg_len + 8 ) );
+DString* dstring_fmt_va( const char* format, va_list va ) {
+    DString* res = dstring_empty( 32 );
     if( !res ) {
         return NULL;
     }
 
-    vsnprintf( res->buf, res->cap, format, va );
-    res->len = msg_len;
+    struct FmtDst dst;
+    memory_zero( &dst, sizeof(dst) );
+    dst.dstr = &res;
 
-    return res->buf;
+    fmt_core_va( &dst, format, va );
+    if( dst.failed ) {
+        dstring_free( res );
+        return NULL;
+    }
+    return res;
 }
 DString* dstring_fmt( const char* format, ... ) {
     va_list va;
@@ -2760,7 +5052,21 @@ DString* dstring_grow( DString* str, usize amount ) {
     usize old_size = sizeof(struct DynamicString) + res->cap;
     usize new_size = old_size + amount;
 
+    if( res->arena ) {
+        // bump-allocate a bigger block, old one
+        // is reclaimed by arena_reset().
+        struct DynamicString* grown = arena_alloc( res->arena, new_size );
+        if( !grown ) {
+            return NULL;
+        }
+        memory_copy( grown, res, old_size );
+        grown->cap += amount;
+        return grown->buf;
+    }
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_DSTRING );
     res = memory_realloc( res, old_size, new_size );
+    memory_tag_leave( tag );
     if( !res ) {
         return NULL;
     }
@@ -3034,6 +5340,10 @@ void dstring_free( DString* str ) {
     if( !head ) {
         return;
     }
+    if( head->arena ) {
+        // arena allocations are released by arena_reset().
+        return;
+    }
     usize total_size = head->cap + sizeof(*head);
     memory_free( head, total_size );
 }
@@ -3130,752 +5440,4554 @@ b32 path_matches_glob( String path, String glob ) {
     return glob.len ? false : true;
 
 }
+b32 glob_compile( String glob, GlobProgram* out_program ) {
+    assertion( out_program, "no program provided!" );
+
+    memory_zero( out_program, sizeof(*out_program) );
+    out_program->pattern = dstring_from_string( glob );
+    if( !out_program->pattern ) {
+        return false;
+    }
+    out_program->ops = darray_empty( sizeof(GlobOp), 4 );
+    if( !out_program->ops ) {
+        dstring_free( out_program->pattern );
+        return false;
+    }
+
+    usize i = 0;
+    while( i < glob.len ) {
+        GlobOp op;
+        memory_zero( &op, sizeof(op) );
+
+        switch( glob.cc[i] ) {
+            case '*': {
+                op.type = GLOB_OP_STAR;
+                // consecutive stars match the same thing as one.
+                while( i < glob.len && glob.cc[i] == '*' ) {
+                    ++i;
+                }
+            } break;
+            case '?': {
+                op.type = GLOB_OP_ANY;
+                ++i;
+            } break;
+            default: {
+                op.type   = GLOB_OP_LITERAL;
+                op.offset = i;
+                while(
+                    i < glob.len && glob.cc[i] != '*' && glob.cc[i] != '?'
+                ) {
+                    ++i;
+                }
+                op.len = i - op.offset;
+            } break;
+        }
+
+        Darray(GlobOp) _new = darray_push( out_program->ops, &op );
+        if( !_new ) {
+            glob_free( out_program );
+            return false;
+        }
+        out_program->ops = _new;
+    }
+
+    // fast path: '*literal' (e.g. *.c) is a pure suffix comparison.
+    if(
+        darray_len( out_program->ops ) == 2        &&
+        out_program->ops[0].type == GLOB_OP_STAR   &&
+        out_program->ops[1].type == GLOB_OP_LITERAL
+    ) {
+        out_program->suffix = string_new(
+            out_program->ops[1].len,
+            out_program->pattern + out_program->ops[1].offset );
+    }
+
+    return true;
+}
+b32 glob_match( const GlobProgram* program, String path ) {
+    assertion( program && program->ops, "program is null!" );
+
+    if( program->suffix.len ) {
+        if( path.len < program->suffix.len ) {
+            return false;
+        }
+        return memory_cmp(
+            path.cc + (path.len - program->suffix.len),
+            program->suffix.cc, program->suffix.len );
+    }
+
+    const GlobOp* ops      = program->ops;
+    const char*   pattern  = program->pattern;
+    usize         op_count = darray_len( program->ops );
+
+    usize op = 0, at = 0;
+    usize star_op = 0, star_at = 0;
+    b32   has_star = false;
+
+    while( at < path.len || op < op_count ) {
+        if( op < op_count ) {
+            GlobOp current = ops[op];
+            switch( current.type ) {
+                case GLOB_OP_STAR: {
+                    // match nothing for now, backtrack
+                    // here on later mismatches.
+                    has_star = true;
+                    star_op  = op + 1;
+                    star_at  = at;
+                    ++op;
+                } continue;
+                case GLOB_OP_ANY: {
+                    if( at < path.len ) {
+                        ++op;
+                        ++at;
+                        continue;
+                    }
+                } break;
+                case GLOB_OP_LITERAL: {
+                    if(
+                        at + current.len <= path.len &&
+                        memory_cmp(
+                            path.cc + at,
+                            pattern + current.offset, current.len )
+                    ) {
+                        ++op;
+                        at += current.len;
+                        continue;
+                    }
+                } break;
+            }
+        }
+
+        // mismatch, let the last star swallow one more character.
+        if( has_star && star_at < path.len ) {
+            ++star_at;
+            at = star_at;
+            op = star_op;
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+void glob_free( GlobProgram* program ) {
+    if( program ) {
+        if( program->pattern ) {
+            dstring_free( program->pattern );
+        }
+        if( program->ops ) {
+            darray_free( program->ops );
+        }
+        memory_zero( program, sizeof(*program) );
+    }
+}
 static b32 path_walk_glob_filter_filter(
     usize index, usize stride, const void* item, void* params
 ) {
     unused(index, stride);
 
-    String glob = *(String*)params;
+    const GlobProgram* program = (const GlobProgram*)params;
     String path = *(String*)item;
 
-    return path_matches_glob( path, glob );
+    return glob_match( program, path );
 }
-String* path_walk_glob_filter( const WalkDirectory* wd, String glob ) {
+String* path_walk_glob_filter_compiled(
+    const WalkDirectory* wd, const GlobProgram* program
+) {
     assertion( wd && wd->paths, "walk result is null!" );
 
     String* res = darray_from_filter(
         sizeof(String), wd->count, wd->paths,
-        path_walk_glob_filter_filter, &glob );
+        path_walk_glob_filter_filter, (void*)program );
     return res;
 }
-b32 path_walk_dir(
-    const char* dir, b32 recursive,
-    b32 include_dirs, WalkDirectory* out_result
-) {
-    assertion( dir, "no path provided!" );
-    assertion( out_result, "no walk dir result provided!" );
+String* path_walk_glob_filter( const WalkDirectory* wd, String glob ) {
+    assertion( wd && wd->paths, "walk result is null!" );
 
-    DString* path = dstring_from_cstr( dir );
-    if( !path ) {
-        return false;
+    GlobProgram program;
+    if( !glob_compile( glob, &program ) ) {
+        return NULL;
     }
+    String* res = path_walk_glob_filter_compiled( wd, &program );
+    glob_free( &program );
+    return res;
+}
 
-    DString* buffer = dstring_empty( 255 );
-    if( !buffer ) {
-        dstring_free( path );
-        cb_error( "path_walk_dir: failed to allocate buffer!" );
-        return false;
+static int walk_index_cmp_strings( String a, String b ) {
+    usize min = a.len < b.len ? a.len : b.len;
+    int   res = memcmp( a.cc, b.cc, min );
+    if( res ) {
+        return res;
     }
-
-    usize count = 0;
-    b32 result = path_walk_dir_internal(
-        &path, recursive, include_dirs, &count, &buffer );
-    dstring_free( path );
-
-    if( !result ) {
-        dstring_free( buffer );
-        return false;
+    if( a.len == b.len ) {
+        return 0;
     }
-
-    if( !count ) {
-        dstring_free( buffer );
-        return true;
+    return a.len < b.len ? -1 : 1;
+}
+// NOTE(alicia): qsort has no context parameter.
+make_tls( const WalkDirectory* ) global_walk_index_sort_wd = NULL;
+static int walk_index_cmp( const void* a, const void* b ) {
+    const WalkDirectory* wd = global_walk_index_sort_wd;
+    return walk_index_cmp_strings(
+        wd->paths[*(const u32*)a], wd->paths[*(const u32*)b] );
+}
+static String walk_index_path_ext( String path ) {
+    usize dot = 0;
+    if( !string_find_rev( path, '.', &dot ) || (dot + 1) >= path.len ) {
+        return string_new( 0, 0 );
     }
-
-    usize total = out_result->count + count;
-    String* paths = darray_empty( sizeof(String), total );
-    if( !paths ) {
-        dstring_free( buffer );
-        return false;
+    usize slash = 0;
+    if( string_find_rev( path, '/', &slash ) && slash > dot ) {
+        // dot belongs to a parent directory.
+        return string_new( 0, 0 );
     }
-
-    if( out_result->buf ) {
-        DString* concat =
-            dstring_append( out_result->buf, string_from_dstring( buffer ) );
-        dstring_free( buffer );
-        if( !concat ) {
-            return false;
-        }
-    } else {
-        out_result->buf = buffer;
+    return string_new( path.len - dot, path.cc + dot );
+}
+b32 path_walk_index_build( const WalkDirectory* wd, WalkIndex* out_index ) {
+    assertion( wd && wd->paths, "walk result is null!" );
+    assertion( out_index, "no index provided!" );
+    memory_zero( out_index, sizeof(*out_index) );
+
+    out_index->wd      = wd;
+    out_index->buckets = darray_empty( sizeof(WalkIndexBucket), 16 );
+    out_index->sorted  = darray_empty( sizeof(u32), wd->count ? wd->count : 1 );
+    if( !out_index->buckets || !out_index->sorted ) {
+        path_walk_index_free( out_index );
+        return false;
     }
 
-    out_result->count = total;
-
-    String rem = string_from_dstring( out_result->buf );
-    while( rem.len ) {
-        usize nul = 0;
-        if( string_find( rem, 0, &nul ) ) {
-            String current = rem;
-            current.len    = nul;
+    for( usize i = 0; i < wd->count; ++i ) {
+        u32 at = (u32)i;
+        expect( darray_try_push( out_index->sorted, &at ),
+            "miscalculated path count!" );
 
-            expect( darray_try_push( paths, &current ), "miscalculated path count!" );
+        String ext = walk_index_path_ext( wd->paths[i] );
+        if( !ext.len ) {
+            continue;
+        }
 
-            rem = string_advance_by( rem, nul + 1 );
-        } else {
-            expect( darray_try_push( paths, &rem ), "miscalculated path count!" );
-            break;
+        WalkIndexBucket* bucket = NULL;
+        for( usize j = 0; j < darray_len( out_index->buckets ); ++j ) {
+            if( string_cmp( out_index->buckets[j].ext, ext ) ) {
+                bucket = out_index->buckets + j;
+                break;
+            }
+        }
+        if( !bucket ) {
+            WalkIndexBucket new_bucket;
+            new_bucket.ext   = ext;
+            new_bucket.paths = darray_empty( sizeof(u32), 16 );
+            if( !new_bucket.paths ) {
+                path_walk_index_free( out_index );
+                return false;
+            }
+            Darray(WalkIndexBucket) _new =
+                darray_push( out_index->buckets, &new_bucket );
+            if( !_new ) {
+                darray_free( new_bucket.paths );
+                path_walk_index_free( out_index );
+                return false;
+            }
+            out_index->buckets = _new;
+            bucket =
+                out_index->buckets + (darray_len( out_index->buckets ) - 1);
         }
-    }
 
-    if( out_result->paths ) {
-        darray_free( out_result->paths );
+        Darray(u32) grown = darray_push( bucket->paths, &at );
+        if( !grown ) {
+            path_walk_index_free( out_index );
+            return false;
+        }
+        bucket->paths = grown;
     }
 
-    out_result->paths = paths;
+    global_walk_index_sort_wd = wd;
+    qsort(
+        out_index->sorted, darray_len( out_index->sorted ),
+        sizeof(u32), walk_index_cmp );
+    global_walk_index_sort_wd = NULL;
     return true;
 }
-void path_walk_free( WalkDirectory* wd ) {
-    if( wd ) {
-        if( wd->paths ) {
-            darray_free( wd->paths );
+static usize walk_index_lower_bound( const WalkIndex* index, String prefix ) {
+    usize lo = 0, hi = darray_len( index->sorted );
+    while( lo < hi ) {
+        usize  mid  = lo + ((hi - lo) / 2);
+        String path = index->wd->paths[index->sorted[mid]];
+        if( path.len > prefix.len ) {
+            path.len = prefix.len;
         }
-        if( wd->buf ) {
-            dstring_free( wd->buf );
+        if( walk_index_cmp_strings( path, prefix ) < 0 ) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
-
-        memory_zero( wd, sizeof(*wd) );
     }
+    return lo;
 }
-b32 dir_remove( const char* path, b32 recursive ) {
-    if( !recursive ) {
-        return dir_remove_internal( path );
+static usize walk_index_upper_bound( const WalkIndex* index, String prefix ) {
+    usize lo = 0, hi = darray_len( index->sorted );
+    while( lo < hi ) {
+        usize  mid  = lo + ((hi - lo) / 2);
+        String path = index->wd->paths[index->sorted[mid]];
+        if( path.len > prefix.len ) {
+            path.len = prefix.len;
+        }
+        if( walk_index_cmp_strings( path, prefix ) <= 0 ) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
     }
+    return lo;
+}
+b32 path_walk_index_dir(
+    const WalkIndex* index, String dir, usize* out_from, usize* out_to
+) {
+    assertion( index && index->sorted, "index is null!" );
+    assertion( out_from && out_to, "no span provided!" );
+
+    while( dir.len && dir.cc[dir.len - 1] == '/' ) {
+        dir.len--;
+    }
+    if( !dir.len || (dir.len + 1) >= CBUILD_LOCAL_BUFFER_CAPACITY ) {
+        return false;
+    }
+
+    ScratchScope scope  = scratch_begin();
+    String       prefix = string_from_cstr(
+        local_fmt( "%.*s/", (int)dir.len, dir.cc ) );
+
+    usize from = walk_index_lower_bound( index, prefix );
+    usize to   = walk_index_upper_bound( index, prefix );
+    scratch_end( scope );
+
+    if( from >= to ) {
+        return false;
+    }
+    *out_from = from;
+    *out_to   = to;
+    return true;
+}
+Darray(String) path_walk_index_glob_filter(
+    const WalkIndex* index, String glob
+) {
+    assertion( index && index->wd, "index is null!" );
+    const WalkDirectory* wd = index->wd;
+
+    // "*.c" style pattern: extension bucket lookup.
+    if( glob.len > 2 && glob.cc[0] == '*' && glob.cc[1] == '.' ) {
+        String ext = string_advance( glob );
+        if(
+            !string_find_set( ext, string_text( "*?/" ), 0 ) &&
+            !string_find( string_advance( ext ), '.', 0 )
+        ) {
+            const WalkIndexBucket* bucket = NULL;
+            for( usize i = 0; i < darray_len( index->buckets ); ++i ) {
+                if( string_cmp( index->buckets[i].ext, ext ) ) {
+                    bucket = index->buckets + i;
+                    break;
+                }
+            }
+            usize count = bucket ? darray_len( bucket->paths ) : 0;
+            Darray(String) res =
+                darray_empty( sizeof(String), count ? count : 1 );
+            if( !res ) {
+                return NULL;
+            }
+            for( usize i = 0; i < count; ++i ) {
+                expect(
+                    darray_try_push( res, wd->paths + bucket->paths[i] ),
+                    "miscalculated path count!" );
+            }
+            return res;
+        }
+    }
+
+    // literal directory before the first wildcard: scan only its span.
+    usize wildcard = glob.len;
+    string_find_set( glob, string_text( "*?" ), &wildcard );
+    usize slash = 0;
+    if( string_find_rev( string_new( wildcard, glob.cc ), '/', &slash ) ) {
+        usize from = walk_index_lower_bound(
+            index, string_new( slash + 1, glob.cc ) );
+        usize to   = walk_index_upper_bound(
+            index, string_new( slash + 1, glob.cc ) );
+
+        GlobProgram program;
+        if( !glob_compile( glob, &program ) ) {
+            return NULL;
+        }
+        Darray(String) res = darray_empty( sizeof(String), 16 );
+        if( !res ) {
+            glob_free( &program );
+            return NULL;
+        }
+        for( usize i = from; i < to; ++i ) {
+            String path = wd->paths[index->sorted[i]];
+            if( !glob_match( &program, path ) ) {
+                continue;
+            }
+            Darray(String) _new = darray_push( res, &path );
+            if( !_new ) {
+                darray_free( res );
+                glob_free( &program );
+                return NULL;
+            }
+            res = _new;
+        }
+        glob_free( &program );
+        return res;
+    }
+
+    // no index helps, full scan.
+    return path_walk_glob_filter( wd, glob );
+}
+void path_walk_index_free( WalkIndex* index ) {
+    if( index ) {
+        if( index->buckets ) {
+            for( usize i = 0; i < darray_len( index->buckets ); ++i ) {
+                darray_free( index->buckets[i].paths );
+            }
+            darray_free( index->buckets );
+        }
+        if( index->sorted ) {
+            darray_free( index->sorted );
+        }
+        memory_zero( index, sizeof(*index) );
+    }
+}
+
+static b32 path_walk_merge(
+    WalkDirectory* out_result, DString* buffer, usize count
+) {
+    if( !count ) {
+        dstring_free( buffer );
+        return true;
+    }
+
+    usize total = out_result->count + count;
+    String* paths = darray_empty( sizeof(String), total );
+    if( !paths ) {
+        dstring_free( buffer );
+        return false;
+    }
+
+    if( out_result->buf ) {
+        DString* concat =
+            dstring_append( out_result->buf, string_from_dstring( buffer ) );
+        dstring_free( buffer );
+        if( !concat ) {
+            darray_free( paths );
+            return false;
+        }
+        out_result->buf = concat;
+    } else {
+        out_result->buf = buffer;
+    }
+
+    out_result->count = total;
+
+    String rem = string_from_dstring( out_result->buf );
+    while( rem.len ) {
+        usize nul = 0;
+        if( string_find( rem, 0, &nul ) ) {
+            String current = rem;
+            current.len    = nul;
+
+            expect( darray_try_push( paths, &current ), "miscalculated path count!" );
+
+            rem = string_advance_by( rem, nul + 1 );
+        } else {
+            expect( darray_try_push( paths, &rem ), "miscalculated path count!" );
+            break;
+        }
+    }
+
+    if( out_result->paths ) {
+        darray_free( out_result->paths );
+    }
+
+    out_result->paths = paths;
+    return true;
+}
+b32 path_walk_dir(
+    const char* dir, b32 recursive,
+    b32 include_dirs, WalkDirectory* out_result
+) {
+    assertion( dir, "no path provided!" );
+    assertion( out_result, "no walk dir result provided!" );
+
+    trace_event_begin( "path_walk_dir" );
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_WALK );
+
+    DString* path = dstring_from_cstr( dir );
+    if( !path ) {
+        memory_tag_leave( tag );
+        trace_event_end();
+        return false;
+    }
+
+    DString* buffer = dstring_empty( 255 );
+    if( !buffer ) {
+        dstring_free( path );
+        cb_error( "path_walk_dir: failed to allocate buffer!" );
+        memory_tag_leave( tag );
+        trace_event_end();
+        return false;
+    }
+
+    usize count = 0;
+    b32 result = path_walk_dir_internal(
+        &path, recursive, include_dirs, &count, &buffer );
+    dstring_free( path );
+
+    if( !result ) {
+        dstring_free( buffer );
+        memory_tag_leave( tag );
+        trace_event_end();
+        return false;
+    }
+
+    b32 merged = path_walk_merge( out_result, buffer, count );
+    memory_tag_leave( tag );
+    trace_event_end();
+    return merged;
+}
+
+struct WalkDirParallel {
+    Mutex    lock;
+    DString* buffer;
+    usize    count;
+    atom     pending; // outstanding directory jobs
+    atom     failed;
+    b32      include_dirs;
+};
+struct WalkDirParallelJob {
+    struct WalkDirParallel* state;
+    DString* path;
+};
+static void path_walk_dir_parallel_proc( void* params ) {
+    struct WalkDirParallelJob* job   = params;
+    struct WalkDirParallel*    state = job->state;
+
+    // job runs on a worker thread, tag is thread-local.
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_WALK );
+
+    usize    count  = 0;
+    DString* buffer = dstring_empty( 255 );
+    Darray(DString*) subdirs = darray_empty( sizeof(DString*), 8 );
+
+    if(
+        !buffer || !subdirs ||
+        !path_walk_dir_shallow(
+            job->path, state->include_dirs, &count, &buffer, &subdirs )
+    ) {
+        atomic_add( &state->failed, 1 );
+    } else {
+        for( usize i = 0; i < darray_len( subdirs ); ++i ) {
+            struct WalkDirParallelJob* subjob = memory_alloc( sizeof(*subjob) );
+            expect( subjob, "failed to allocate walk job!" );
+            subjob->state = state;
+            subjob->path  = subdirs[i];
+            subdirs[i]    = NULL;
+
+            atomic_add( &state->pending, 1 );
+            job_enqueue( path_walk_dir_parallel_proc, subjob );
+        }
+
+        if( count ) {
+            mutex_lock( &state->lock );
+            DString* _new =
+                dstring_append( state->buffer, string_from_dstring( buffer ) );
+            if( _new ) {
+                state->buffer = _new;
+                state->count += count;
+            } else {
+                atomic_add( &state->failed, 1 );
+            }
+            mutex_unlock( &state->lock );
+        }
+    }
+
+    if( buffer ) {
+        dstring_free( buffer );
+    }
+    if( subdirs ) {
+        for( usize i = 0; i < darray_len( subdirs ); ++i ) {
+            if( subdirs[i] ) {
+                dstring_free( subdirs[i] );
+            }
+        }
+        darray_free( subdirs );
+    }
+    dstring_free( job->path );
+    memory_free( job, sizeof(*job) );
+
+    memory_tag_leave( tag );
+
+    fence();
+    atomic_add( &state->pending, -1 );
+}
+b32 path_walk_dir_parallel(
+    const char* dir, b32 include_dirs, WalkDirectory* out_result
+) {
+    assertion( dir, "no path provided!" );
+    assertion( out_result, "no walk dir result provided!" );
+
+    struct WalkDirParallel state;
+    memory_zero( &state, sizeof(state) );
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_WALK );
+
+    expect( mutex_create( &state.lock ), "failed to create walk mutex!" );
+    state.include_dirs = include_dirs;
+    state.buffer       = dstring_empty( 255 );
+    if( !state.buffer ) {
+        mutex_destroy( &state.lock );
+        cb_error( "path_walk_dir_parallel: failed to allocate buffer!" );
+        memory_tag_leave( tag );
+        return false;
+    }
+
+    struct WalkDirParallelJob* job = memory_alloc( sizeof(*job) );
+    expect( job, "failed to allocate walk job!" );
+    job->state = &state;
+    job->path  = dstring_from_cstr( dir );
+    if( !job->path ) {
+        memory_free( job, sizeof(*job) );
+        dstring_free( state.buffer );
+        mutex_destroy( &state.lock );
+        memory_tag_leave( tag );
+        return false;
+    }
+
+    atomic_add( &state.pending, 1 );
+    job_enqueue( path_walk_dir_parallel_proc, job );
+
+    while( state.pending ) {
+        thread_sleep(1);
+    }
+    fence();
+
+    mutex_destroy( &state.lock );
+
+    if( state.failed ) {
+        dstring_free( state.buffer );
+        memory_tag_leave( tag );
+        return false;
+    }
+
+    b32 merged = path_walk_merge( out_result, state.buffer, state.count );
+    memory_tag_leave( tag );
+    return merged;
+}
+void path_walk_free( WalkDirectory* wd ) {
+    if( wd ) {
+        if( wd->paths ) {
+            darray_free( wd->paths );
+        }
+        if( wd->buf ) {
+            dstring_free( wd->buf );
+        }
+
+        memory_zero( wd, sizeof(*wd) );
+    }
+}
+
+// NOTE(alicia): walk snapshot binary layout, all fields native-endian:
+// header, dir_count directory mtimes, dir_count nul-terminated
+// directory paths, buf_len bytes of nul-separated walked paths.
+#define WALK_SNAPSHOT_MAGIC   (0x4B574243) // 'CBWK'
+#define WALK_SNAPSHOT_VERSION (1)
+struct WalkSnapshotHeader {
+    u32 magic;
+    u32 version;
+    u64 count;       // number of walked paths
+    u64 dir_count;   // number of directory records
+    u64 dir_buf_len; // size of directory path blob
+    u64 buf_len;     // size of walked path blob
+};
+static String path_walk_snapshot_parent( String path ) {
+    usize sep = 0;
+    if( string_find_rev( path, '/', &sep ) ) {
+        String parent = path;
+        parent.len    = sep ? sep : 1; // parent of "/x" is "/"
+        return parent;
+    }
+    return string_text( "." );
+}
+// collect the sorted set of directories containing walked paths.
+static Darray(String) path_walk_snapshot_dirs( const WalkDirectory* wd ) {
+    Darray(String) dirs = darray_empty( sizeof(String), 16 );
+    if( !dirs ) {
+        return NULL;
+    }
+    for( usize i = 0; i < wd->count; ++i ) {
+        String parent = path_walk_snapshot_parent( wd->paths[i] );
+
+        usize lo = 0, hi = darray_len( dirs );
+        while( lo < hi ) {
+            usize mid = lo + ((hi - lo) / 2);
+            int   cmp = walk_index_cmp_strings( parent, dirs[mid] );
+            if( !cmp ) {
+                lo = hi = SIZE_MAX;
+            } else if( cmp > 0 ) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if( lo == SIZE_MAX ) {
+            continue; // already collected.
+        }
+
+        void* _new = lo == darray_len( dirs )
+            ? darray_push( dirs, &parent )
+            : darray_emplace( dirs, &parent, lo );
+        if( !_new ) {
+            darray_free( dirs );
+            return NULL;
+        }
+        dirs = _new;
+    }
+    return dirs;
+}
+b32 path_walk_save( const char* path, const WalkDirectory* wd ) {
+    assertion( path, "no path provided!" );
+    assertion( wd, "no walk dir result provided!" );
+
+    String buf = wd->buf
+        ? string_from_dstring( wd->buf ) : string_empty();
+
+    Darray(String) dirs = path_walk_snapshot_dirs( wd );
+    if( !dirs ) {
+        return false;
+    }
+    usize dir_count = darray_len( dirs );
+
+    i64* mtimes = memory_alloc( dir_count * sizeof(i64) );
+    DString* dir_buf = dstring_empty( 255 );
+    if( !mtimes || !dir_buf ) {
+        memory_free( mtimes, dir_count * sizeof(i64) );
+        dstring_free( dir_buf );
+        darray_free( dirs );
+        return false;
+    }
+    for( usize i = 0; i < dir_count; ++i ) {
+        ScratchScope scope = scratch_begin();
+        const char* dir = local_fmt( "%.*s", (int)dirs[i].len, dirs[i].cc );
+        mtimes[i] = (i64)file_query_time_modify( dir );
+        scratch_end( scope );
+
+        DString* appended = dstring_append( dir_buf, dirs[i] );
+        if( appended ) {
+            appended = dstring_push( appended, 0 );
+        }
+        if( !appended ) {
+            memory_free( mtimes, dir_count * sizeof(i64) );
+            dstring_free( dir_buf );
+            darray_free( dirs );
+            return false;
+        }
+        dir_buf = appended;
+    }
+    darray_free( dirs );
+
+    struct WalkSnapshotHeader header;
+    memory_zero( &header, sizeof(header) );
+    header.magic       = WALK_SNAPSHOT_MAGIC;
+    header.version     = WALK_SNAPSHOT_VERSION;
+    header.count       = wd->count;
+    header.dir_count   = dir_count;
+    header.dir_buf_len = dstring_len( dir_buf );
+    header.buf_len     = buf.len;
+
+    FD file;
+    b32 res = fd_open(
+        path, FOPEN_WRITE | FOPEN_CREATE | FOPEN_TRUNCATE, &file );
+    if( res ) {
+        res =
+            fd_write( &file, sizeof(header), &header, NULL )         &&
+            fd_write( &file, dir_count * sizeof(i64), mtimes, NULL ) &&
+            fd_write( &file, dstring_len( dir_buf ), dir_buf, NULL ) &&
+            fd_write( &file, buf.len, buf.cc, NULL );
+        fd_close( &file );
+    }
+
+    memory_free( mtimes, dir_count * sizeof(i64) );
+    dstring_free( dir_buf );
+    return res;
+}
+b32 path_walk_load( const char* path, WalkDirectory* out_result ) {
+    assertion( path, "no path provided!" );
+    assertion( out_result, "no walk dir result provided!" );
+
+    FileMap map;
+    if( !file_map( path, &map ) ) {
+        return false;
+    }
+
+    const struct WalkSnapshotHeader* header =
+        (const struct WalkSnapshotHeader*)map.view.cc;
+    if(
+        map.view.len < sizeof(*header)             ||
+        header->magic   != WALK_SNAPSHOT_MAGIC     ||
+        header->version != WALK_SNAPSHOT_VERSION   ||
+        map.view.len    != sizeof(*header) +
+            (header->dir_count * sizeof(i64)) +
+            header->dir_buf_len + header->buf_len
+    ) {
+        cb_warn( "path_walk_load: '%s' is not a valid walk snapshot!", path );
+        file_unmap( &map );
+        return false;
+    }
+
+    const i64*  mtimes  = (const i64*)(header + 1);
+    const char* dir_buf = (const char*)(mtimes + header->dir_count);
+    const char* buf     = dir_buf + header->dir_buf_len;
+
+    // reject the snapshot if any recorded directory changed.
+    const char* dir = dir_buf;
+    for( u64 i = 0; i < header->dir_count; ++i ) {
+        usize rem = header->dir_buf_len - (usize)(dir - dir_buf);
+        usize len = strnlen( dir, rem );
+        if( len == rem ) {
+            file_unmap( &map );
+            return false; // truncated directory blob.
+        }
+        if( (i64)file_query_time_modify( dir ) != mtimes[i] ) {
+            file_unmap( &map );
+            return false;
+        }
+        dir += len + 1;
+    }
+
+    if( !header->count ) {
+        file_unmap( &map );
+        return true;
+    }
+
+    DString* buffer = dstring_new( header->buf_len, buf );
+    usize    count  = header->count;
+    file_unmap( &map );
+    if( !buffer ) {
+        return false;
+    }
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_WALK );
+    b32 merged = path_walk_merge( out_result, buffer, count );
+    memory_tag_leave( tag );
+    return merged;
+}
+
+// NOTE(alicia): xxHash64, seed 0. https://xxhash.com
+#define HASH_PRIME_1 (0x9E3779B185EBCA87ULL)
+#define HASH_PRIME_2 (0xC2B2AE3D27D4EB4FULL)
+#define HASH_PRIME_3 (0x165667B19E3779F9ULL)
+#define HASH_PRIME_4 (0x85EBCA77C2B2AE63ULL)
+#define HASH_PRIME_5 (0x27D4EB2F165667C5ULL)
+
+static u64 hash_rotl( u64 x, u32 r ) {
+    return (x << r) | (x >> (64 - r));
+}
+static u64 hash_read64( const u8* at ) {
+    u64 res;
+    memory_copy( &res, at, sizeof(res) );
+    return res;
+}
+static u64 hash_round( u64 acc, u64 lane ) {
+    acc += lane * HASH_PRIME_2;
+    acc  = hash_rotl( acc, 31 );
+    acc *= HASH_PRIME_1;
+    return acc;
+}
+static u64 hash_merge_round( u64 hash, u64 acc ) {
+    hash ^= hash_round( 0, acc );
+    return (hash * HASH_PRIME_1) + HASH_PRIME_4;
+}
+u64 hash_buffer( usize len, const void* buf ) {
+    const u8* at  = (const u8*)buf;
+    const u8* end = at + len;
+    u64 hash;
+
+    if( len >= 32 ) {
+        u64 acc1 = HASH_PRIME_1 + HASH_PRIME_2;
+        u64 acc2 = HASH_PRIME_2;
+        u64 acc3 = 0;
+        u64 acc4 = (u64)0 - HASH_PRIME_1;
+        do {
+            acc1 = hash_round( acc1, hash_read64( at ) ); at += 8;
+            acc2 = hash_round( acc2, hash_read64( at ) ); at += 8;
+            acc3 = hash_round( acc3, hash_read64( at ) ); at += 8;
+            acc4 = hash_round( acc4, hash_read64( at ) ); at += 8;
+        } while( (usize)(end - at) >= 32 );
+
+        hash =
+            hash_rotl( acc1,  1 ) + hash_rotl( acc2,  7 ) +
+            hash_rotl( acc3, 12 ) + hash_rotl( acc4, 18 );
+        hash = hash_merge_round( hash, acc1 );
+        hash = hash_merge_round( hash, acc2 );
+        hash = hash_merge_round( hash, acc3 );
+        hash = hash_merge_round( hash, acc4 );
+    } else {
+        hash = HASH_PRIME_5;
+    }
+
+    hash += (u64)len;
+
+    while( (usize)(end - at) >= 8 ) {
+        hash ^= hash_round( 0, hash_read64( at ) );
+        hash  = (hash_rotl( hash, 27 ) * HASH_PRIME_1) + HASH_PRIME_4;
+        at += 8;
+    }
+    if( (usize)(end - at) >= 4 ) {
+        u32 lane;
+        memory_copy( &lane, at, sizeof(lane) );
+        hash ^= (u64)lane * HASH_PRIME_1;
+        hash  = (hash_rotl( hash, 23 ) * HASH_PRIME_2) + HASH_PRIME_3;
+        at += 4;
+    }
+    while( at < end ) {
+        hash ^= (u64)(*at++) * HASH_PRIME_5;
+        hash  = hash_rotl( hash, 11 ) * HASH_PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+b32 hash_file( const char* path, u64* out_hash ) {
+    FileMap map;
+    if( !file_map( path, &map ) ) {
+        return false;
+    }
+
+    *out_hash = hash_buffer( map.view.len, map.view.cc );
+    file_unmap( &map );
+    return true;
+}
+
+struct HashFileJob {
+    const char* path;
+    u64*        out_hash;
+    atom*       pending;
+    atom*       failed;
+};
+static void hash_file_batch_proc( void* params ) {
+    struct HashFileJob* job = params;
+    if( !hash_file( job->path, job->out_hash ) ) {
+        atomic_add( job->failed, 1 );
+    }
+    atomic_add( job->pending, -1 );
+    memory_free( job, sizeof(*job) );
+}
+b32 hash_file_batch( usize count, const char** paths, u64* out_hashes ) {
+    atom pending = 0;
+    atom failed  = 0;
+
+    usize remainder = count;
+    for( usize i = 0; i < count; ++i ) {
+        struct HashFileJob* job = memory_alloc( sizeof(*job) );
+        if( !job ) {
+            remainder = i;
+            break;
+        }
+        job->path     = paths[i];
+        job->out_hash = out_hashes + i;
+        job->pending  = &pending;
+        job->failed   = &failed;
+
+        atomic_add( &pending, 1 );
+        job_enqueue( hash_file_batch_proc, job );
+    }
+    // hash anything that couldn't be enqueued on this thread.
+    for( usize i = remainder; i < count; ++i ) {
+        if( !hash_file( paths[i], out_hashes + i ) ) {
+            atomic_add( &failed, 1 );
+        }
+    }
+
+    while( pending ) {
+        thread_sleep( 1 );
+    }
+    return failed == 0;
+}
+
+struct FileCopyJob {
+    const char* dst;
+    const char* src;
+    atom*       pending;
+    atom*       failed;
+};
+static void file_copy_batch_proc( void* params ) {
+    struct FileCopyJob* job = params;
+    if( !file_copy( job->dst, job->src ) ) {
+        atomic_add( job->failed, 1 );
+    }
+    atomic_add( job->pending, -1 );
+    memory_free( job, sizeof(*job) );
+}
+b32 file_copy_batch( usize count, const FileCopy* copies ) {
+    atom pending = 0;
+    atom failed  = 0;
+
+    usize remainder = count;
+    for( usize i = 0; i < count; ++i ) {
+        struct FileCopyJob* job = memory_alloc( sizeof(*job) );
+        if( !job ) {
+            remainder = i;
+            break;
+        }
+        job->dst     = copies[i].dst;
+        job->src     = copies[i].src;
+        job->pending = &pending;
+        job->failed  = &failed;
+
+        atomic_add( &pending, 1 );
+        job_enqueue( file_copy_batch_proc, job );
+    }
+    // copy anything that couldn't be enqueued on this thread.
+    for( usize i = remainder; i < count; ++i ) {
+        if( !file_copy( copies[i].dst, copies[i].src ) ) {
+            atomic_add( &failed, 1 );
+        }
+    }
+
+    while( pending ) {
+        thread_sleep( 1 );
+    }
+    return failed == 0;
+}
+
+// NOTE(alicia): stats a contiguous slice of paths, reusing directory
+// handles between paths that share a parent. Implemented per-platform.
+static void file_stat_many( usize count, const char** paths, FileStat* out_stats );
+
+#define FILE_STAT_PARALLEL_THRESHOLD (64)
+
+struct FileStatJob {
+    usize        count;
+    const char** paths;
+    FileStat*    out_stats;
+    atom*        pending;
+};
+static void file_stat_batch_proc( void* params ) {
+    struct FileStatJob* job = params;
+    file_stat_many( job->count, job->paths, job->out_stats );
+    atomic_add( job->pending, -1 );
+    memory_free( job, sizeof(*job) );
+}
+void file_stat_batch( usize count, const char** paths, FileStat* out_stats ) {
+    if( count < FILE_STAT_PARALLEL_THRESHOLD ) {
+        file_stat_many( count, paths, out_stats );
+        return;
+    }
+
+    atom pending = 0;
+
+    // NOTE(alicia): slices rather than one job per path so each worker's
+    // directory handle cache actually sees neighboring paths.
+    usize partition = (count + (CBUILD_THREAD_COUNT - 1)) / CBUILD_THREAD_COUNT;
+    usize remainder = count;
+    for( usize start = 0; start < count; start += partition ) {
+        usize len = count - start;
+        if( len > partition ) {
+            len = partition;
+        }
+
+        struct FileStatJob* job = memory_alloc( sizeof(*job) );
+        if( !job ) {
+            remainder = start;
+            break;
+        }
+        job->count     = len;
+        job->paths     = paths + start;
+        job->out_stats = out_stats + start;
+        job->pending   = &pending;
+
+        atomic_add( &pending, 1 );
+        job_enqueue( file_stat_batch_proc, job );
+        remainder = start + len;
+    }
+    // stat anything that couldn't be enqueued on this thread.
+    if( remainder < count ) {
+        file_stat_many( count - remainder, paths + remainder, out_stats + remainder );
+    }
+
+    while( pending ) {
+        thread_sleep( 1 );
+    }
+}
+
+
+#define PATH_POOL_TABLE_CAPACITY (1024)
+
+b32 path_pool_create( PathPool* out_pool ) {
+    assertion( out_pool, "no pool provided!" );
+    memory_zero( out_pool, sizeof(*out_pool) );
+
+    out_pool->buf       = dstring_empty( 255 );
+    out_pool->entries   = darray_empty( sizeof(PathPoolEntry), 255 );
+    out_pool->table_cap = PATH_POOL_TABLE_CAPACITY;
+    out_pool->table     = memory_alloc( sizeof(u32) * out_pool->table_cap );
+
+    if( !out_pool->buf || !out_pool->entries || !out_pool->table ) {
+        path_pool_free( out_pool );
+        return false;
+    }
+    return true;
+}
+static b32 path_pool_entry_is_root( const PathPool* pool, PathID id ) {
+    const PathPoolEntry* entry = pool->entries + (id - 1);
+    return entry->name_len == 1 && pool->buf[entry->name_offset] == '/';
+}
+static u64 path_pool_hash( PathID parent, String name ) {
+    return hash_buffer( name.len, name.cc ) ^ ((u64)parent * HASH_PRIME_1);
+}
+static u32* path_pool_table_slot(
+    const PathPool* pool, u32* table, u32 table_cap,
+    PathID parent, String name
+) {
+    u32 mask = table_cap - 1;
+    u32 slot = (u32)path_pool_hash( parent, name ) & mask;
+    for( ;; ) {
+        u32 id = table[slot];
+        if( !id ) {
+            return table + slot;
+        }
+        const PathPoolEntry* entry = pool->entries + (id - 1);
+        if(
+            entry->parent == parent && entry->name_len == name.len &&
+            memory_cmp( pool->buf + entry->name_offset, name.cc, name.len )
+        ) {
+            return table + slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+static b32 path_pool_table_grow( PathPool* pool ) {
+    u32  grown_cap = pool->table_cap * 2;
+    u32* grown     = memory_alloc( sizeof(u32) * grown_cap );
+    if( !grown ) {
+        return false;
+    }
+
+    for( usize i = 0; i < darray_len( pool->entries ); ++i ) {
+        const PathPoolEntry* entry = pool->entries + i;
+        String name =
+            string_new( entry->name_len, pool->buf + entry->name_offset );
+        *path_pool_table_slot( pool, grown, grown_cap, entry->parent, name ) =
+            (u32)(i + 1);
+    }
+
+    memory_free( pool->table, sizeof(u32) * pool->table_cap );
+    pool->table     = grown;
+    pool->table_cap = grown_cap;
+    return true;
+}
+static PathID path_pool_intern_component(
+    PathPool* pool, PathID parent, String name
+) {
+    // keep the table under 3/4 full.
+    if( (darray_len( pool->entries ) + 1) * 4 >= (usize)pool->table_cap * 3 ) {
+        if( !path_pool_table_grow( pool ) ) {
+            return 0;
+        }
+    }
+
+    u32* slot = path_pool_table_slot(
+        pool, pool->table, pool->table_cap, parent, name );
+    if( *slot ) {
+        return *slot;
+    }
+
+    PathPoolEntry entry;
+    memory_zero( &entry, sizeof(entry) );
+    entry.parent      = parent;
+    entry.name_offset = (u32)dstring_len( pool->buf );
+    entry.name_len    = (u32)name.len;
+    entry.len         = (u32)name.len;
+    if( parent ) {
+        const PathPoolEntry* p = pool->entries + (parent - 1);
+        entry.len += p->len;
+        if( !path_pool_entry_is_root( pool, parent ) ) {
+            entry.len += 1; // separator.
+        }
+    }
+
+    DString* buf = dstring_append( pool->buf, name );
+    if( !buf ) {
+        return 0;
+    }
+    pool->buf = buf;
+
+    Darray(PathPoolEntry) entries = darray_push( pool->entries, &entry );
+    if( !entries ) {
+        return 0;
+    }
+    pool->entries = entries;
+
+    // the push can't have invalidated slot,
+    // table only grows at the top of this function.
+    *slot = (u32)darray_len( pool->entries );
+    return *slot;
+}
+PathID path_pool_intern( PathPool* pool, String path ) {
+    assertion( pool && pool->entries, "pool is null!" );
+
+    PathID id = 0;
+    usize  at = 0;
+    if( path.len && path.cc[0] == '/' ) {
+        id = path_pool_intern_component( pool, 0, string_text( "/" ) );
+        if( !id ) {
+            return 0;
+        }
+        at = 1;
+    }
+
+    while( at < path.len ) {
+        while( at < path.len && path.cc[at] == '/' ) {
+            at++;
+        }
+        usize start = at;
+        while( at < path.len && path.cc[at] != '/' ) {
+            at++;
+        }
+        if( at == start ) {
+            break;
+        }
+        id = path_pool_intern_component(
+            pool, id, string_new( at - start, path.cc + start ) );
+        if( !id ) {
+            return 0;
+        }
+    }
+    return id;
+}
+String path_pool_get( const PathPool* pool, PathID id ) {
+    assertion( pool && pool->entries, "pool is null!" );
+    assertion(
+        id && id <= darray_len( pool->entries ), "invalid path id %u!", id );
+
+    const PathPoolEntry* entry = pool->entries + (id - 1);
+    usize len = entry->len;
+    expect( len < CBUILD_LOCAL_BUFFER_CAPACITY,
+        "interned path is longer than local buffer!" );
+
+    char* buf = (char*)local_byte_buffer();
+    usize at  = len;
+    for( PathID current = id; current; ) {
+        const PathPoolEntry* e = pool->entries + (current - 1);
+        at -= e->name_len;
+        memory_copy( buf + at, pool->buf + e->name_offset, e->name_len );
+
+        current = e->parent;
+        if( current && !path_pool_entry_is_root( pool, current ) ) {
+            buf[--at] = '/';
+        }
+    }
+    return string_new( len, buf );
+}
+Darray(PathID) path_pool_intern_walk(
+    PathPool* pool, const WalkDirectory* wd
+) {
+    assertion( wd && wd->paths, "walk result is null!" );
+
+    Darray(PathID) res =
+        darray_empty( sizeof(PathID), wd->count ? wd->count : 1 );
+    if( !res ) {
+        return NULL;
+    }
+    for( usize i = 0; i < wd->count; ++i ) {
+        PathID id = path_pool_intern( pool, wd->paths[i] );
+        if( !id ) {
+            darray_free( res );
+            return NULL;
+        }
+        expect( darray_try_push( res, &id ), "miscalculated path count!" );
+    }
+    return res;
+}
+Darray(PathID) path_pool_glob_filter_compiled(
+    const PathPool* pool, const Darray(PathID) paths,
+    const GlobProgram* program
+) {
+    assertion( pool && pool->entries, "pool is null!" );
+    assertion( paths, "no paths provided!" );
+
+    usize count = darray_len( paths );
+    Darray(PathID) res = darray_empty( sizeof(PathID), count ? count : 1 );
+    if( !res ) {
+        return NULL;
+    }
+    for( usize i = 0; i < count; ++i ) {
+        ScratchScope scope = scratch_begin();
+        b32 match = glob_match( program, path_pool_get( pool, paths[i] ) );
+        scratch_end( scope );
+
+        if( match ) {
+            expect(
+                darray_try_push( res, paths + i ),
+                "miscalculated path count!" );
+        }
+    }
+    return res;
+}
+Darray(PathID) path_pool_glob_filter(
+    const PathPool* pool, const Darray(PathID) paths, String glob
+) {
+    GlobProgram program;
+    if( !glob_compile( glob, &program ) ) {
+        return NULL;
+    }
+    Darray(PathID) res = path_pool_glob_filter_compiled(
+        pool, paths, &program );
+    glob_free( &program );
+    return res;
+}
+void path_pool_free( PathPool* pool ) {
+    if( pool ) {
+        if( pool->buf ) {
+            dstring_free( pool->buf );
+        }
+        if( pool->entries ) {
+            darray_free( pool->entries );
+        }
+        if( pool->table ) {
+            memory_free( pool->table, sizeof(u32) * pool->table_cap );
+        }
+        memory_zero( pool, sizeof(*pool) );
+    }
+}
+
+b32 dir_remove( const char* path, b32 recursive ) {
+    if( !recursive ) {
+        return dir_remove_internal( path );
+    }
+
+    WalkDirectory wd;
+    memory_zero( &wd, sizeof(wd) );
+
+    if( !path_walk_dir( path, true, false, &wd ) ) {
+        cb_error( "dir_remove: failed to walk directory '%s'!", path );
+        return false;
+    }
+
+    for( usize i = 0; i < wd.count; ++i ) {
+        if( !file_remove( wd.paths[i].cc ) ) {
+            cb_error( "dir_remove: failed to remove file '%s'!", wd.paths[i].cc );
+
+            path_walk_free( &wd );
+            return false;
+        }
+    }
+
+    path_walk_free( &wd );
+
+    if( !path_walk_dir( path, true, true, &wd ) ) {
+        cb_error( "dir_remove: failed to walk directory '%s'!", path );
+        return false;
+    }
+
+    for( usize i = 0; i < wd.count; ++i ) {
+        if( !dir_remove_internal( wd.paths[i].cc ) ) {
+            cb_error( "dir_remove: failed to remove dir '%s'!", wd.paths[i].cc );
+
+            path_walk_free( &wd );
+            return false;
+        }
+    }
+
+    path_walk_free( &wd );
+    return dir_remove_internal( path );
+}
+
+b32 fd_write_fmt_va( FD* file, const char* format, va_list va ) {
+    char*  formatted = local_fmt_va( format, va );
+    String part      = string_from_cstr( formatted );
+    return fd_write_many( file, 1, &part );
+}
+b32 fd_write_fmt( FD* file, const char* format, ... ) {
+    va_list va;
+    va_start( va, format );
+    b32 res = fd_write_fmt_va( file, format, va );
+    va_end( va );
+    return res;
+}
+
+void* darray_empty_arena( Arena* opt_arena, usize stride, usize cap ) {
+    usize size = sizeof(struct DynamicArray) + (stride * cap);
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_DARRAY );
+    struct DynamicArray* res = opt_arena
+        ? (struct DynamicArray*)arena_alloc( opt_arena, size )
+        : (struct DynamicArray*)memory_alloc( size );
+    memory_tag_leave( tag );
+    if( !res ) {
+        return NULL;
+    }
+    res->stride = stride;
+    res->cap    = cap;
+    res->arena  = opt_arena;
+    return res->buf;
+}
+void* darray_empty( usize stride, usize cap ) {
+    return darray_empty_arena( NULL, stride, cap );
+}
+void* darray_from_array( usize stride, usize len, const void* buf ) {
+    struct DynamicArray* res = darray_head( darray_empty( stride, len + 2 ) );
+    if( !res ) {
+        return NULL;
+    }
+
+    memory_copy( res->buf, buf, len * stride );
+    res->len = len;
+
+    return res->buf;
+}
+usize darray_static_memory_requirement( usize stride, usize cap ) {
+    return (stride * cap) + sizeof(struct DynamicArray);
+}
+void* darray_static( usize stride, usize cap, void* buf ) {
+    struct DynamicArray* res = buf;
+    res->stride = stride;
+    res->cap    = cap;
+    res->len    = 0;
+    res->arena  = NULL;
+    return res->buf;
+}
+void* darray_join( usize stride,
+    usize lhs_len, const void* lhs, usize rhs_len, const void* rhs
+) {
+    struct DynamicArray* res =
+        darray_head( darray_empty( stride, lhs_len + rhs_len + 2 ) );
+    if( !res ) {
+        return NULL;
+    }
+
+    memory_copy( res->buf, lhs, stride * lhs_len );
+    memory_copy( res->buf + (stride * lhs_len), rhs, rhs_len );
+    res->len = lhs_len + rhs_len;
+
+    return res;
+}
+void* darray_from_filter(
+    usize stride, usize len, const void* src,
+    DarrayFilterFN* filter, void* filter_params
+) {
+    const u8* src_bytes = src;
+
+    void* res = darray_empty( stride, 10 );
+    if( !res ) {
+        return NULL;
+    }
+
+    for( usize i = 0; i < len; ++i ) {
+        const u8* item = src_bytes + (stride * i);
+        if( filter( i, stride, item, filter_params ) ) {
+            void* _new = darray_push( res, item );
+            if( !_new ) {
+                darray_free( res );
+                return NULL;
+            }
+            res = _new;
+        }
+    }
+
+    return res;
+}
+
+// NOTE(alicia): below this length, job dispatch overhead
+// outweighs any win from running darray algorithms in parallel.
+#define DARRAY_PARALLEL_THRESHOLD (1024)
+
+struct DarrayFilterJob {
+    const u8*       src;
+    usize           stride;
+    usize           index; // first item of this partition
+    usize           count;
+    DarrayFilterFN* filter;
+    void*           params;
+    u8*             keep;  // one flag per item, shared across jobs
+    atom*           pending;
+};
+static void darray_filter_proc( void* params ) {
+    struct DarrayFilterJob* job = params;
+    for( usize i = job->index; i < job->index + job->count; ++i ) {
+        job->keep[i] = job->filter(
+            i, job->stride, job->src + (job->stride * i), job->params ) != 0;
+    }
+    fence();
+    atomic_add( job->pending, -1 );
+    memory_free( job, sizeof(*job) );
+}
+void* darray_from_filter_parallel(
+    usize stride, usize len, const void* src,
+    DarrayFilterFN* filter, void* filter_params
+) {
+    if( len < DARRAY_PARALLEL_THRESHOLD ) {
+        return darray_from_filter( stride, len, src, filter, filter_params );
+    }
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_DARRAY );
+    u8* keep = memory_alloc( len );
+    memory_tag_leave( tag );
+    if( !keep ) {
+        return darray_from_filter( stride, len, src, filter, filter_params );
+    }
+
+    const u8* src_bytes = src;
+    atom pending    = 0;
+    usize partition = (len + (CBUILD_THREAD_COUNT - 1)) / CBUILD_THREAD_COUNT;
+    usize remainder = len;
+    for( usize start = 0; start < len; start += partition ) {
+        struct DarrayFilterJob* job = memory_alloc( sizeof(*job) );
+        if( !job ) {
+            remainder = start;
+            break;
+        }
+        job->src     = src_bytes;
+        job->stride  = stride;
+        job->index   = start;
+        job->count   = partition > (len - start) ? (len - start) : partition;
+        job->filter  = filter;
+        job->params  = filter_params;
+        job->keep    = keep;
+        job->pending = &pending;
+
+        atomic_add( &pending, 1 );
+        job_enqueue( darray_filter_proc, job );
+    }
+    // filter anything that couldn't be enqueued on this thread.
+    for( usize i = remainder; i < len; ++i ) {
+        keep[i] = filter(
+            i, stride, src_bytes + (stride * i), filter_params ) != 0;
+    }
+
+    while( pending ) {
+        thread_sleep( 1 );
+    }
+    fence();
+
+    usize matches = 0;
+    for( usize i = 0; i < len; ++i ) {
+        matches += keep[i];
+    }
+
+    // copy survivors in order so the result matches the serial filter.
+    void* res = darray_empty( stride, matches ? matches : 1 );
+    if( res ) {
+        struct DynamicArray* head = darray_head( res );
+        u8* dst = head->buf;
+        for( usize i = 0; i < len; ++i ) {
+            if( keep[i] ) {
+                memory_copy( dst, src_bytes + (stride * i), stride );
+                dst += stride;
+            }
+        }
+        head->len = matches;
+    }
+
+    memory_free( keep, len );
+    return res;
+}
+usize darray_filter_indices(
+    usize stride, usize len, const void* src,
+    DarrayFilterFN* filter, void* filter_params, u32* out_indices
+) {
+    const u8* src_bytes = src;
+    usize matches = 0;
+    for( usize i = 0; i < len; ++i ) {
+        if( filter( i, stride, src_bytes + (stride * i), filter_params ) ) {
+            out_indices[matches++] = (u32)i;
+        }
+    }
+    return matches;
+}
+
+struct DarrayMapJob {
+    u8*          items;
+    usize        stride;
+    usize        index;
+    usize        count;
+    DarrayMapFN* map;
+    void*        params;
+    atom*        pending;
+};
+static void darray_map_proc( void* params ) {
+    struct DarrayMapJob* job = params;
+    for( usize i = job->index; i < job->index + job->count; ++i ) {
+        job->map( i, job->stride, job->items + (job->stride * i), job->params );
+    }
+    fence();
+    atomic_add( job->pending, -1 );
+    memory_free( job, sizeof(*job) );
+}
+void darray_map( void* darray, DarrayMapFN* map, void* map_params ) {
+    struct DynamicArray* head = darray_head( darray );
+    for( usize i = 0; i < head->len; ++i ) {
+        map( i, head->stride, head->buf + (head->stride * i), map_params );
+    }
+}
+void darray_map_parallel( void* darray, DarrayMapFN* map, void* map_params ) {
+    struct DynamicArray* head = darray_head( darray );
+    usize len = head->len;
+    if( len < DARRAY_PARALLEL_THRESHOLD ) {
+        darray_map( darray, map, map_params );
+        return;
+    }
+
+    atom pending    = 0;
+    usize partition = (len + (CBUILD_THREAD_COUNT - 1)) / CBUILD_THREAD_COUNT;
+    usize remainder = len;
+    for( usize start = 0; start < len; start += partition ) {
+        struct DarrayMapJob* job = memory_alloc( sizeof(*job) );
+        if( !job ) {
+            remainder = start;
+            break;
+        }
+        job->items   = head->buf;
+        job->stride  = head->stride;
+        job->index   = start;
+        job->count   = partition > (len - start) ? (len - start) : partition;
+        job->map     = map;
+        job->params  = map_params;
+        job->pending = &pending;
+
+        atomic_add( &pending, 1 );
+        job_enqueue( darray_map_proc, job );
+    }
+    // map anything that couldn't be enqueued on this thread.
+    for( usize i = remainder; i < len; ++i ) {
+        map( i, head->stride, head->buf + (head->stride * i), map_params );
+    }
+
+    while( pending ) {
+        thread_sleep( 1 );
+    }
+    fence();
+}
+
+struct DarraySortJob {
+    u8*              items;
+    usize            stride;
+    usize            count;
+    DarraySortCmpFN* cmp;
+    atom*            pending;
+};
+static void darray_sort_proc( void* params ) {
+    struct DarraySortJob* job = params;
+    qsort( job->items, job->count, job->stride, job->cmp );
+    fence();
+    atomic_add( job->pending, -1 );
+    memory_free( job, sizeof(*job) );
+}
+static void darray_sort_merge(
+    usize stride, DarraySortCmpFN* cmp, u8* dst,
+    const u8* lhs, usize lhs_len, const u8* rhs, usize rhs_len
+) {
+    usize l = 0, r = 0;
+    while( l < lhs_len && r < rhs_len ) {
+        if( cmp( lhs + (stride * l), rhs + (stride * r) ) <= 0 ) {
+            memory_copy( dst, lhs + (stride * l), stride );
+            l++;
+        } else {
+            memory_copy( dst, rhs + (stride * r), stride );
+            r++;
+        }
+        dst += stride;
+    }
+    if( l < lhs_len ) {
+        memory_copy( dst, lhs + (stride * l), stride * (lhs_len - l) );
+    }
+    if( r < rhs_len ) {
+        memory_copy( dst, rhs + (stride * r), stride * (rhs_len - r) );
+    }
+}
+void darray_sort( void* darray, DarraySortCmpFN* cmp ) {
+    struct DynamicArray* head = darray_head( darray );
+    qsort( head->buf, head->len, head->stride, cmp );
+}
+void darray_sort_parallel( void* darray, DarraySortCmpFN* cmp ) {
+    struct DynamicArray* head = darray_head( darray );
+    usize len    = head->len;
+    usize stride = head->stride;
+    if( len < DARRAY_PARALLEL_THRESHOLD ) {
+        darray_sort( darray, cmp );
+        return;
+    }
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_DARRAY );
+    u8* temp = memory_alloc( len * stride );
+    memory_tag_leave( tag );
+    if( !temp ) {
+        darray_sort( darray, cmp );
+        return;
+    }
+
+    // sort partitions on workers, then merge pairs on this thread.
+    atom pending    = 0;
+    usize partition = (len + (CBUILD_THREAD_COUNT - 1)) / CBUILD_THREAD_COUNT;
+    usize remainder = len;
+    for( usize start = 0; start < len; start += partition ) {
+        struct DarraySortJob* job = memory_alloc( sizeof(*job) );
+        if( !job ) {
+            remainder = start;
+            break;
+        }
+        job->items   = head->buf + (stride * start);
+        job->stride  = stride;
+        job->count   = partition > (len - start) ? (len - start) : partition;
+        job->cmp     = cmp;
+        job->pending = &pending;
+
+        atomic_add( &pending, 1 );
+        job_enqueue( darray_sort_proc, job );
+    }
+    // sort anything that couldn't be enqueued on this thread.
+    for( usize start = remainder; start < len; start += partition ) {
+        usize count = partition > (len - start) ? (len - start) : partition;
+        qsort( head->buf + (stride * start), count, stride, cmp );
+    }
+
+    while( pending ) {
+        thread_sleep( 1 );
+    }
+    fence();
+
+    u8* from = head->buf;
+    u8* to   = temp;
+    for( usize width = partition; width < len; width *= 2 ) {
+        for( usize start = 0; start < len; start += width * 2 ) {
+            usize lhs_len = width > (len - start) ? (len - start) : width;
+            usize rhs_len = 0;
+            if( start + width < len ) {
+                rhs_len = width > (len - (start + width))
+                    ? (len - (start + width)) : width;
+            }
+            darray_sort_merge(
+                stride, cmp, to + (stride * start),
+                from + (stride * start), lhs_len,
+                from + (stride * (start + width)), rhs_len );
+        }
+        u8* swap = from;
+        from     = to;
+        to       = swap;
+    }
+
+    if( from != head->buf ) {
+        memory_copy( head->buf, from, len * stride );
+    }
+    memory_free( temp, len * stride );
+}
+
+void* darray_grow( void* darray, usize amount ) {
+    struct DynamicArray* res = darray_head( darray );
+    usize old_size = (res->stride * res->cap) + sizeof(*res);
+    usize new_size = (res->stride * amount) + old_size;
+
+    if( res->arena ) {
+        // bump-allocate a bigger block, old one
+        // is reclaimed by arena_reset().
+        struct DynamicArray* grown = arena_alloc( res->arena, new_size );
+        if( !grown ) {
+            return NULL;
+        }
+        memory_copy( grown, res, old_size );
+        grown->cap += amount;
+        return grown->buf;
+    }
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_DARRAY );
+    res = memory_realloc( res, old_size, new_size );
+    memory_tag_leave( tag );
+    if( !res ) {
+        return NULL;
+    }
+
+    res->cap += amount;
+    return res->buf;
+}
+void* darray_clone( const void* darray ) {
+    return darray_from_array(
+        darray_stride( darray ), darray_len( darray ), darray );
+}
+void darray_clear( void* darray ) {
+    struct DynamicArray* head = darray_head( darray );
+    memory_zero( head->buf, head->len * head->stride );
+    head->len = 0;
+}
+void* darray_set_len( void* darray, usize len ) {
+    if( len > darray_cap( darray ) ) {
+        usize diff = len - darray_cap( darray );
+
+        struct DynamicArray* head = darray_head( darray_grow( darray, diff ) );
+        if( !head ) {
+            return NULL;
+        }
+
+        head->len = len;
+        return head->buf;
+    } else if( len > darray_len( darray ) ) {
+        struct DynamicArray* head = darray_head( darray );
+        usize diff = head->len - len;
+        memory_zero( head->buf + len, head->stride * diff );
+        head->len = diff;
+
+        return head->buf;
+    } else {
+        darray_truncate( darray, len );
+        return darray;
+    }
+}
+void darray_truncate( void* darray, usize max ) {
+    struct DynamicArray* head = darray_head( darray );
+    if( max >= head->len ) {
+        return;
+    }
+    usize diff = head->len - max;
+    memory_zero( head->buf + max, head->stride * diff );
+    head->len = max;
+}
+void darray_trim( void* darray, usize amount ) {
+    struct DynamicArray* head = darray_head( darray );
+    darray_truncate( head->buf, amount > head->len ? 0 : head->len - amount );
+}
+b32 darray_try_push( void* darray, const void* item ) {
+    struct DynamicArray* head = darray_head( darray );
+    if( head->len == head->cap ) {
+        return false;
+    }
+
+    memory_copy( head->buf + (head->stride * head->len), item, head->stride );
+    head->len++;
+
+    return true;
+}
+b32 darray_try_emplace( void* darray, const void* item, usize at ) {
+    struct DynamicArray* head = darray_head( darray );
+    if( head->len == head->cap ) {
+        return false;
+    }
+    if( at >= head->len ) {
+        cb_warn(
+            "darray_emplace: attempted to emplace past darray bounds! "
+            "len: %zu index: %zu", head->len, at );
+        return false;
+    }
+
+    memory_move(
+        head->buf + ( head->stride * ( at + 1 ) ),
+        head->buf + ( head->stride * at ),
+        head->stride * ( head->len - at ) );
+    memory_copy( head->buf + ( head->stride * at ), item, head->stride );
+    head->len++;
+
+    return true;
+}
+b32 darray_try_insert( void* darray, usize count, const void* items, usize at ) {
+    struct DynamicArray* head = darray_head( darray );
+    if( head->len + count > head->cap ) {
+        return false;
+    }
+    if( at >= head->len ) {
+        cb_warn(
+            "darray_insert: attempted to insert past darray bounds! "
+            "len: %zu index: %zu", head->len, at );
+        return false;
+    }
+
+    memory_move(
+        head->buf + ( head->stride * ( at + count ) ),
+        head->buf + ( head->stride * at ),
+        head->stride * ( head->len - at ) );
+    memory_copy( head->buf + ( head->stride * at ), items, head->stride * count );
+    head->len += count;
+
+    return true;
+}
+b32 darray_try_append( void* darray, usize count, const void* items ) {
+    struct DynamicArray* head = darray_head( darray );
+    if( head->len + count > head->cap ) {
+        return false;
+    }
+
+    memory_copy(
+        head->buf + (head->stride * head->len),
+        items, head->stride * count );
+    head->len += count;
+
+    return true;
+}
+b32 darray_pop( void* darray, void* opt_out_item ) {
+    struct DynamicArray* head = darray_head( darray );
+    if( !head->len ) {
+        return false;
+    }
+
+    head->len--;
+    if( opt_out_item ) {
+        memory_copy(
+            opt_out_item, head->buf + (head->stride * head->len), head->stride );
+    }
+
+    memory_zero( head->buf + (head->stride * head->len), head->stride );
+    return true;
+}
+void* darray_push( void* darray, const void* item ) {
+    void* res = darray;
+    if( darray_try_push( res, item ) ) {
+        return res;
+    }
+
+    res = darray_grow( res, 5 );
+    if( !res ) {
+        return NULL;
+    }
+
+    darray_try_push( res, item );
+    return res;
+}
+void* darray_emplace( void* darray, const void* item, usize at ) {
+    if( at >= darray_len( darray ) ) {
+        cb_warn(
+            "darray_emplace: attempted to emplace past darray bounds! "
+            "len: %zu index: %zu", darray_len( darray ), at );
+        return NULL;
+    }
+
+    void* res = darray;
+    if( darray_try_emplace( res, item, at ) ) {
+        return res;
+    }
+
+    res = darray_grow( res, 5 );
+    if( !res ) {
+        return NULL;
+    }
+
+    darray_try_emplace( res, item, at );
+    return res;
+}
+void* darray_insert( void* darray, usize count, const void* items, usize at ) {
+    struct DynamicArray* res = darray_head( darray );
+
+    if( at >= res->len ) {
+        cb_warn(
+            "darray_insert: attempted to insert past darray bounds! "
+            "len: %zu index: %zu", res->len, at );
+        return false;
+    }
+
+    if( darray_try_insert( res->buf, count, items, at ) ) {
+        return res->buf;
+    }
+
+    res = darray_head( darray_grow( res->buf, (count - (res->cap - res->len)) + 5 ) );
+    if( !res ) {
+        return NULL;
+    }
+
+    darray_try_insert( res->buf, count, items, at );
+    return res->buf;
+}
+void* darray_append( void* darray, usize count, const void* items ) {
+    struct DynamicArray* res = darray_head( darray );
+    if( darray_try_append( res->buf, count, items ) ) {
+        return res;
+    }
+
+    res = darray_head( darray_grow( res->buf, (count - (res->cap - res->len)) + 5 ) );
+    if( !res ) {
+        return NULL;
+    }
+
+    darray_try_append( res->buf, count, items );
+    return res->buf;
+}
+b32 darray_remove( void* darray, usize index ) {
+
+    struct DynamicArray* head = darray_head( darray );
+    if( !head->len || index > head->len ) {
+        cb_warn(
+            "darray_remove: attempted to remove past array bounds! "
+            "len: %zu index: %zu", head->len, index );
+        return false;
+    }
+    if( index == (head->len - 1) ) {
+        return darray_pop( darray, 0 );
+    }
+
+    void* item_to_remove = head->buf + (head->stride * index);
+    void* item_next      = (u8*)item_to_remove + head->stride;
+    usize move_size      = (head->buf + (head->stride * head->cap)) - (u8*)item_next;
+
+    memory_move( item_to_remove, item_next, move_size );
+    head->len--;
+    memory_zero( head->buf + (head->stride * head->len), head->stride );
+
+    return true;
+}
+b32 darray_remove_range( void* darray, usize from_inclusive, usize to_exclusive ) {
+    assertion( from_inclusive < to_exclusive,
+        "darray_remove_range: invalid range provided! (%zu, %zu]",
+        from_inclusive, to_exclusive );
+    struct DynamicArray* head = darray_head( darray );
+    if( !head->len || from_inclusive >= head->len || to_exclusive > head->len ) {
+        cb_warn(
+            "darray_remove_range: attempted to remove past array bounds! "
+            "len: %zu range: (%zu, %zu]", head->len, from_inclusive, to_exclusive );
+        return false;
+    }
+
+    // TODO(alicia): reimplement this properly
+    for( usize i = from_inclusive; i < to_exclusive; ++i ) {
+        darray_remove( darray, from_inclusive );
+    }
+
+    return true;
+}
+usize darray_remaining( const void* darray ) {
+    return darray_cap( darray ) - darray_len( darray );
+}
+usize darray_len( const void* darray ) {
+    return ((struct DynamicArray*)darray - 1)->len;
+}
+usize darray_cap( const void* darray ) {
+    return ((struct DynamicArray*)darray - 1)->cap;
+}
+usize darray_stride( const void* darray ) {
+    return ((struct DynamicArray*)darray - 1)->stride;
+}
+usize darray_total_size( const void* darray ) {
+    return
+        sizeof(struct DynamicArray) +
+        (darray_cap( darray ) * darray_stride( darray ));
+}
+b32 darray_is_empty( const void* darray ) {
+    return darray_len( darray ) == 0;
+}
+b32 darray_is_full( const void* darray ) {
+    return darray_len( darray ) == darray_cap( darray );
+}
+void* darray_head( void* darray ) {
+    if( !darray ) {
+        return NULL;
+    }
+    return (struct DynamicArray*)darray - 1;
+}
+const void* darray_head_const( const void* darray ) {
+    if( !darray ) {
+        return NULL;
+    }
+    return (const struct DynamicArray*)darray - 1;
+}
+void darray_free( void* darray ) {
+    if( darray ) {
+        struct DynamicArray* head = darray_head( darray );
+        if( head->arena ) {
+            // arena allocations are released by arena_reset().
+            return;
+        }
+        usize total_size = (head->cap * head->stride) + sizeof(*head);
+        memory_free( head, total_size );
+    }
+}
+
+b32 job_enqueue( JobFN* job, void* params ) {
+    volatile struct JobQueue* queue = get_job_queue();
+
+    struct JobEntry entry;
+    entry.proc   = job;
+    entry.params = params;
+
+    fence();
+
+    job_deque_push( (struct JobDeque*)(queue->deques + thread_id()), entry );
+    atomic_add( &queue->pending, 1 );
+
+    event_signal( (Event*)&queue->wakeup );
+    return true;
+}
+b32 job_enqueue_timed( JobFN* job, void* params, u32 ms ) {
+    unused(ms);
+    return job_enqueue( job, params );
+}
+b32 job_wait_next( u32 ms ) {
+    volatile struct JobQueue* queue = get_job_queue();
+
+    u32 current = queue->pending;
+    if( !current ) {
+        return true;
+    }
+
+    f64 deadline = timer_milliseconds() + (f64)ms;
+    for( ;; ) {
+        atom generation = event_prepare( (Event*)&queue->complete );
+        if( queue->pending < current ) {
+            return true;
+        }
+        if( ms == MT_WAIT_INFINITE ) {
+            event_wait( (Event*)&queue->complete, generation );
+        } else {
+            f64 now = timer_milliseconds();
+            if(
+                now >= deadline ||
+                !event_wait_timed(
+                    (Event*)&queue->complete, generation,
+                    (u32)(deadline - now) + 1 )
+            ) {
+                return queue->pending < current;
+            }
+        }
+    }
+}
+b32 job_wait_all( u32 ms ) {
+    volatile struct JobQueue* queue = get_job_queue();
+
+    b32 res = true;
+    f64 deadline = timer_milliseconds() + (f64)ms;
+    for( ;; ) {
+        atom generation = event_prepare( (Event*)&queue->complete );
+        if( !queue->pending ) {
+            break;
+        }
+        if( ms == MT_WAIT_INFINITE ) {
+            event_wait( (Event*)&queue->complete, generation );
+        } else {
+            f64 now = timer_milliseconds();
+            if(
+                now >= deadline ||
+                !event_wait_timed(
+                    (Event*)&queue->complete, generation,
+                    (u32)(deadline - now) + 1 )
+            ) {
+                res = !queue->pending;
+                break;
+            }
+        }
+    }
+
+    if( global_logger_async ) {
+        logger_flush();
+    }
+    return res;
+}
+
+// NOTE(alicia): futex on linux, WaitOnAddress on windows,
+// sleep-poll everywhere else. callers always recheck their
+// condition so spurious returns are harmless.
+static void futex_wait( atom* address, atom expected, u32 ms );
+static void futex_wake( atom* address, b32 all );
+
+#define EVENT_SPIN_COUNT      (128)
+#define SPIN_MUTEX_SPIN_COUNT (128)
+
+b32 event_create( Event* out_event ) {
+    out_event->state = 0;
+    return true;
+}
+atom event_prepare( Event* event ) {
+    atom generation = event->state;
+    fence();
+    return generation;
+}
+void event_wait( Event* event, atom generation ) {
+    for( u32 spin = 0; spin < EVENT_SPIN_COUNT; ++spin ) {
+        if( event->state != generation ) {
+            fence();
+            return;
+        }
+    }
+    while( event->state == generation ) {
+        futex_wait( &event->state, generation, MT_WAIT_INFINITE );
+    }
+    fence();
+}
+b32 event_wait_timed( Event* event, atom generation, u32 ms ) {
+    if( ms == MT_WAIT_INFINITE ) {
+        event_wait( event, generation );
+        return true;
+    }
+    for( u32 spin = 0; spin < EVENT_SPIN_COUNT; ++spin ) {
+        if( event->state != generation ) {
+            fence();
+            return true;
+        }
+    }
+    f64 deadline = timer_milliseconds() + (f64)ms;
+    while( event->state == generation ) {
+        f64 now = timer_milliseconds();
+        if( now >= deadline ) {
+            return false;
+        }
+        futex_wait( &event->state, generation, (u32)(deadline - now) + 1 );
+    }
+    fence();
+    return true;
+}
+void event_signal( Event* event ) {
+    fence();
+    atomic_add( &event->state, 1 );
+    futex_wake( &event->state, false );
+}
+void event_signal_all( Event* event ) {
+    fence();
+    atomic_add( &event->state, 1 );
+    futex_wake( &event->state, true );
+}
+void event_destroy( Event* event ) {
+    event->state = 0;
+}
+
+b32 spin_mutex_create( SpinMutex* out_mutex ) {
+    out_mutex->state = 0;
+    return true;
+}
+b32 spin_mutex_try_lock( SpinMutex* mutex ) {
+    if( atomic_compare_swap( &mutex->state, 0, 1 ) == 0 ) {
+        fence();
+        return true;
+    }
+    return false;
+}
+void spin_mutex_lock( SpinMutex* mutex ) {
+    for( u32 spin = 0; spin < SPIN_MUTEX_SPIN_COUNT; ++spin ) {
+        if( atomic_compare_swap( &mutex->state, 0, 1 ) == 0 ) {
+            fence();
+            return;
+        }
+    }
+    for( ;; ) {
+        // mark contended so unlock knows to wake a waiter.
+        atom state = atomic_compare_swap( &mutex->state, 1, 2 );
+        if( state == 0 ) {
+            // locking as contended is conservative, unlock
+            // issues at most one unnecessary wake.
+            if( atomic_compare_swap( &mutex->state, 0, 2 ) == 0 ) {
+                fence();
+                return;
+            }
+            continue;
+        }
+        futex_wait( &mutex->state, 2, MT_WAIT_INFINITE );
+    }
+}
+void spin_mutex_unlock( SpinMutex* mutex ) {
+    fence();
+    if( atomic_compare_swap( &mutex->state, 1, 0 ) == 1 ) {
+        return;
+    }
+    // contended, wake one parked waiter.
+    atomic_compare_swap( &mutex->state, 2, 0 );
+    futex_wake( &mutex->state, false );
+}
+void spin_mutex_destroy( SpinMutex* mutex ) {
+    mutex->state = 0;
+}
+
+u32 thread_id(void) {
+    return global_thread_id;
+}
+
+struct JobGraphNode {
+    JobFN* proc;
+    void*  params;
+    u32    remaining; // unfinished dependencies
+    b32    finished;
+    Darray(u32) dependents;
+};
+struct JobGraph {
+    Mutex lock;
+    atom  unfinished;
+    Darray(struct JobGraphNode) nodes;
+};
+
+static struct JobGraph global_job_graph;
+
+static struct JobGraph* get_job_graph(void) {
+    if( !global_job_graph.nodes ) {
+        expect(
+            mutex_create( &global_job_graph.lock ),
+            "failed to create job graph mutex!" );
+        global_job_graph.nodes =
+            darray_empty( sizeof(struct JobGraphNode), 16 );
+        expect( global_job_graph.nodes, "failed to allocate job graph!" );
+    }
+    return &global_job_graph;
+}
+static void job_graph_node_proc( void* params ) {
+    struct JobGraph* graph = &global_job_graph;
+    usize index = ((usize)params) - 1;
+
+    mutex_lock( &graph->lock );
+    JobFN* proc        = graph->nodes[index].proc;
+    void*  node_params = graph->nodes[index].params;
+    mutex_unlock( &graph->lock );
+
+    proc( node_params );
+    fence();
+
+    mutex_lock( &graph->lock );
+    // nodes may have been reallocated while job was running.
+    struct JobGraphNode* node = graph->nodes + index;
+    node->finished = true;
+    if( node->dependents ) {
+        for( usize i = 0; i < darray_len( node->dependents ); ++i ) {
+            u32 dep_index = node->dependents[i];
+            struct JobGraphNode* dependent = graph->nodes + dep_index;
+            if( !--dependent->remaining ) {
+                job_enqueue(
+                    job_graph_node_proc, (void*)((usize)dep_index + 1) );
+            }
+        }
+    }
+    mutex_unlock( &graph->lock );
+
+    atomic_add( &graph->unfinished, -1 );
+}
+JobID job_graph_add(
+    JobFN* job, void* params, usize dependency_count, const JobID* dependencies
+) {
+    struct JobGraph* graph = get_job_graph();
+
+    mutex_lock( &graph->lock );
+
+    struct JobGraphNode node;
+    memory_zero( &node, sizeof(node) );
+    node.proc   = job;
+    node.params = params;
+
+    Darray(struct JobGraphNode) _new = darray_push( graph->nodes, &node );
+    expect( _new, "failed to allocate job graph node!" );
+    graph->nodes = _new;
+
+    u32 index = (u32)(darray_len( graph->nodes ) - 1);
+
+    for( usize i = 0; i < dependency_count; ++i ) {
+        JobID id = dependencies[i];
+        assertion(
+            id && (id <= index), "invalid job graph dependency! id: %u", id );
+
+        struct JobGraphNode* dep = graph->nodes + (id - 1);
+        if( dep->finished ) {
+            continue;
+        }
+        if( !dep->dependents ) {
+            dep->dependents = darray_empty( sizeof(u32), 4 );
+            expect( dep->dependents, "failed to allocate job dependents!" );
+        }
+        Darray(u32) _deps = darray_push( dep->dependents, &index );
+        expect( _deps, "failed to allocate job dependents!" );
+        dep->dependents = _deps;
+
+        graph->nodes[index].remaining++;
+    }
+
+    atomic_add( &graph->unfinished, 1 );
+    b32 ready = graph->nodes[index].remaining == 0;
+
+    mutex_unlock( &graph->lock );
+
+    if( ready ) {
+        job_enqueue( job_graph_node_proc, (void*)((usize)index + 1) );
+    }
+    return index + 1;
+}
+static b32 job_graph_finished( struct JobGraph* graph, usize index ) {
+    // nodes may be reallocated by concurrent adds, only read under lock.
+    mutex_lock( &graph->lock );
+    b32 res = graph->nodes[index].finished;
+    mutex_unlock( &graph->lock );
+    return res;
+}
+b32 job_graph_wait( JobID id, u32 ms ) {
+    struct JobGraph* graph = get_job_graph();
+
+    mutex_lock( &graph->lock );
+    assertion(
+        id && (id <= darray_len( graph->nodes )),
+        "invalid job graph id! id: %u", id );
+    mutex_unlock( &graph->lock );
+
+    usize index = id - 1;
+    if( ms == MT_WAIT_INFINITE ) {
+        while( !job_graph_finished( graph, index ) ) {
+            thread_sleep(1);
+        }
+        return true;
+    } else for( u32 i = 0; i < ms; ++i ) {
+        if( job_graph_finished( graph, index ) ) {
+            return true;
+        }
+        thread_sleep(1);
+    }
+
+    return job_graph_finished( graph, index );
+}
+b32 job_graph_wait_all( u32 ms ) {
+    struct JobGraph* graph = get_job_graph();
+
+    if( ms == MT_WAIT_INFINITE ) {
+        while( graph->unfinished ) {
+            thread_sleep(1);
+        }
+        return true;
+    } else for( u32 i = 0; i < ms; ++i ) {
+        if( !graph->unfinished ) {
+            return true;
+        }
+        thread_sleep(1);
+    }
+
+    return !graph->unfinished;
+}
+void job_graph_clear(void) {
+    struct JobGraph* graph = get_job_graph();
+
+    mutex_lock( &graph->lock );
+    expect( !graph->unfinished,
+        "attempted to clear job graph with unfinished jobs!" );
+
+    for( usize i = 0; i < darray_len( graph->nodes ); ++i ) {
+        if( graph->nodes[i].dependents ) {
+            darray_free( graph->nodes[i].dependents );
+        }
+    }
+    darray_clear( graph->nodes );
+    mutex_unlock( &graph->lock );
+}
+b32 command_builder_new( const char* exe, CommandBuilder* out_builder ) {
+    memory_zero( out_builder, sizeof(*out_builder) );
+    out_builder->buf = darray_empty( sizeof(char), 128 );
+    if( !out_builder->buf ) {
+        return false;
+    }
+    out_builder->args = darray_empty( sizeof(const char*), 5 );
+    if( !out_builder->args ) {
+        darray_free( out_builder->buf );
+        return false;
+    }
+    command_builder_push( out_builder, exe );
+    return true;
+}
+void command_builder_clear( CommandBuilder* builder ) {
+    darray_clear( builder->buf );
+    darray_clear( builder->args );
+    builder->flat_dirty = true;
+}
+b32 command_builder_push( CommandBuilder* builder, const char* arg ) {
+    usize arg_len = strlen( arg );
+    if( darray_remaining( builder->buf ) < arg_len + 1 ) {
+        const char*  old_buf = builder->buf;
+        Darray(char) new_buf = darray_grow( builder->buf, darray_cap( builder->buf ) );
+        if( !new_buf ) {
+            return false;
+        }
+        if( new_buf != old_buf ) {
+            // rebase argument pointers, they point into buf.
+            for( usize i = 0; i < darray_len( builder->args ); ++i ) {
+                if( builder->args[i] ) {
+                    builder->args[i] = new_buf + (builder->args[i] - old_buf);
+                }
+            }
+        }
+        builder->buf = new_buf;
+    }
+    if( darray_remaining( builder->args ) < 1 ) {
+        Darray(const char*) new_buf =
+            darray_grow( builder->args, darray_cap( builder->args ) );
+        if( !new_buf ) {
+            return false;
+        }
+        builder->args = new_buf;
+    }
+    const char* new_arg = builder->buf + darray_len( builder->buf );
+    darray_try_append( builder->buf, arg_len + 1, arg );
+
+    darray_pop( builder->args, 0 );
+    darray_try_push( builder->args, &new_arg );
+    const char* null = 0;
+    darray_try_push( builder->args, &null );
+
+    builder->flat_dirty = true;
+    return true;
+}
+b32 __internal_command_builder_append(
+    CommandBuilder* builder, const char* first, ...
+) {
+    if( !command_builder_push( builder, first ) ) {
+        return false;
+    }
+    va_list va;
+    va_start( va, first );
+
+    for( ;; ) {
+        const char* next = va_arg( va, const char* );
+        if( !next ) {
+            break;
+        }
+
+        if( !command_builder_push( builder, next ) ) {
+            va_end(va);
+            return false;
+        }
+    }
+
+    va_end(va);
+    return true;
+}
+b32 command_builder_append_list(
+    CommandBuilder* builder, usize count, const char** args
+) {
+    for( usize i = 0; i < count; ++i ) {
+        if( !command_builder_push( builder, args[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+Command command_builder_cmd( CommandBuilder* builder ) {
+    return (Command){
+        .count = darray_len(builder->args) - 1,
+        .args  = builder->args,
+    };
+}
+String command_builder_flatten( CommandBuilder* builder ) {
+    if( builder->flat && !builder->flat_dirty ) {
+        return string_from_dstring( builder->flat );
+    }
+    if( builder->flat ) {
+        dstring_free( builder->flat );
+        builder->flat = NULL;
+    }
+    Command cmd    = command_builder_cmd( builder );
+    builder->flat  = command_flatten_dstring( &cmd );
+    if( !builder->flat ) {
+        return string_empty();
+    }
+    builder->flat_dirty = false;
+    return string_from_dstring( builder->flat );
+}
+b32 command_builder_cmd_response(
+    CommandBuilder* builder, const char* path, Command* out_cmd
+) {
+    usize arg_count = darray_len( builder->args );
+    assertion( arg_count > 1, "builder has no executable!" );
+
+    FD file;
+    if( !fd_open( path, FOPEN_WRITE | FOPEN_CREATE | FOPEN_TRUNCATE, &file ) ) {
+        cb_error( "command_builder_cmd_response: failed to open '%s'!", path );
+        return false;
+    }
+    // skip executable name and trailing null, one argument per line.
+    for( usize i = 1; i + 1 < arg_count; ++i ) {
+        const char* arg = builder->args[i];
+        String as_string = string_from_cstr( arg );
+        b32 quote = string_find( as_string, ' ', 0 ) != false;
+        if( !fd_write_fmt( &file, quote ? "\"%s\"\n" : "%s\n", arg ) ) {
+            cb_error(
+                "command_builder_cmd_response: failed to write '%s'!", path );
+            fd_close( &file );
+            return false;
+        }
+    }
+    fd_close( &file );
+
+    const char* exe     = builder->args[0];
+    usize       exe_len = strlen( exe );
+    usize       path_len = strlen( path );
+    DString* response = dstring_empty( exe_len + path_len + 3 );
+    if( !response ) {
+        return false;
+    }
+    expect(
+        dstring_append( response, string_new( exe_len, exe ) ) == response,
+        "miscalculated response length!" );
+    expect(
+        dstring_push( response, 0 ) == response,
+        "miscalculated response length!" );
+    expect(
+        dstring_push( response, '@' ) == response,
+        "miscalculated response length!" );
+    expect(
+        dstring_append( response, string_new( path_len, path ) ) == response,
+        "miscalculated response length!" );
+
+    if( builder->response ) {
+        dstring_free( builder->response );
+    }
+    builder->response         = response;
+    builder->response_args[0] = response;
+    builder->response_args[1] = response + exe_len + 1;
+    builder->response_args[2] = NULL;
+
+    *out_cmd = (Command){
+        .count = 2,
+        .args  = builder->response_args,
+    };
+    return true;
+}
+void command_builder_free( CommandBuilder* builder ) {
+    darray_free( builder->buf );
+    darray_free( builder->args );
+    if( builder->flat ) {
+        dstring_free( builder->flat );
+    }
+    if( builder->response ) {
+        dstring_free( builder->response );
+    }
+    memory_zero( builder, sizeof(*builder) );
+}
+DString* command_flatten_dstring( const Command* command ) {
+    usize total_len = 1;
+    for( usize i = 0; i < command->count; ++i ) {
+        total_len += strlen( command->args[i] ) + 3; // to account for potential "" and space
+    }
+    DString* res = dstring_empty( total_len );
+    if( !res ) {
+        return NULL;
+    }
+
+    for( usize i = 0; i < command->count; ++i ) {
+        const char* current = command->args[i];
+        if( !current ) {
+            continue;
+        }
+
+        usize current_len = strlen( current );
+        if( !current_len ) {
+            continue;
+        }
+
+        b32 contains_space = false;
+        String arg = string_new( current_len, current );
+        if( string_find( arg, ' ', 0 ) ) {
+            expect( dstring_push( res, '"' ) == res, "miscalculated total_len!" );
+            contains_space = true;
+        }
+
+        expect( dstring_append( res, arg ) == res, "miscalculated total_len!" );
+
+        if( contains_space ) {
+            expect( dstring_push( res, '"' ) == res, "miscalculated total_len!" );
+        }
+
+        if( i + 1 != command->count ) {
+            expect( dstring_push( res, ' ' ) == res, "miscalculated total_len!" );
+        }
+    }
+
+    return res;
+}
+
+#define PROCESS_RESOLVE_HEADER "cbuild-tools-1"
+
+#if defined(PLATFORM_WINDOWS)
+    #define PROCESS_RESOLVE_PATH_SEPARATOR ';'
+#else
+    #define PROCESS_RESOLVE_PATH_SEPARATOR ':'
+#endif
+
+struct ProcessResolveEntry {
+    usize name_offset; // offset of name in resolver buffer
+    usize name_len;
+    usize path_offset; // offset of nul-terminated path in resolver buffer
+    b32   hit;         // answered a lookup, worth persisting
+};
+struct ProcessResolver {
+    b32 scanned;
+    Darray(struct ProcessResolveEntry) entries; // sorted by name
+    DString* buf;
+};
+static struct ProcessResolver global_process_resolver;
+
+// NOTE(alicia): the resolver is shared mutable state and process_exec
+// routes every spawn through it, including spawns from the process
+// pool service thread and parallel jobs. Public entry points take the
+// resolver mutex, internal find/insert/scan assume it is already held.
+static void process_resolve_lock(void) {
+    if( global_is_mt ) {
+        mutex_lock( &global_process_resolve_mutex );
+    }
+}
+static void process_resolve_unlock(void) {
+    if( global_is_mt ) {
+        mutex_unlock( &global_process_resolve_mutex );
+    }
+}
+
+// per-platform: is path an executable file?
+static b32 process_resolve_executable( const char* path );
+
+static String process_resolve_entry_name(
+    const struct ProcessResolveEntry* entry
+) {
+    return string_new(
+        entry->name_len, global_process_resolver.buf + entry->name_offset );
+}
+static b32 process_resolve_find( String name, usize* out_index ) {
+    Darray(struct ProcessResolveEntry) entries =
+        global_process_resolver.entries;
+    usize lo = 0, hi = entries ? darray_len( entries ) : 0;
+    while( lo < hi ) {
+        usize mid = lo + ((hi - lo) / 2);
+        int   cmp = walk_index_cmp_strings(
+            name, process_resolve_entry_name( entries + mid ) );
+        if( !cmp ) {
+            *out_index = mid;
+            return true;
+        }
+        if( cmp > 0 ) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *out_index = lo;
+    return false;
+}
+static b32 process_resolve_insert( String name, String path, b32 hit ) {
+    struct ProcessResolver* rs = &global_process_resolver;
+
+    usize at = 0;
+    if( process_resolve_find( name, &at ) ) {
+        return true; // earlier directory in PATH wins.
+    }
+
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_PROCESS );
+    b32 res = false;
+    do {
+        if( !rs->buf ) {
+            rs->buf = dstring_empty( 255 );
+        }
+        if( !rs->entries ) {
+            rs->entries = darray_empty(
+                sizeof(struct ProcessResolveEntry), 16 );
+        }
+        if( !rs->buf || !rs->entries ) {
+            break;
+        }
+
+        struct ProcessResolveEntry entry;
+        memory_zero( &entry, sizeof(entry) );
+        entry.name_offset = dstring_len( rs->buf );
+        entry.name_len    = name.len;
+        entry.hit         = hit;
+
+        DString* buf = dstring_append( rs->buf, name );
+        if( buf ) {
+            entry.path_offset = dstring_len( buf );
+            buf = dstring_append( buf, path );
+        }
+        if( buf ) {
+            buf = dstring_push( buf, 0 );
+        }
+        if( !buf ) {
+            break;
+        }
+        rs->buf = buf;
+
+        void* _new = at == darray_len( rs->entries )
+            ? darray_push( rs->entries, &entry )
+            : darray_emplace( rs->entries, &entry, at );
+        if( !_new ) {
+            break;
+        }
+        rs->entries = _new;
+        res = true;
+    } while( false );
+    memory_tag_leave( tag );
+    return res;
+}
+static void process_resolve_scan(void) {
+    struct ProcessResolver* rs = &global_process_resolver;
+    if( rs->scanned ) {
+        return;
+    }
+    rs->scanned = true;
+
+    const char* path_env = getenv( "PATH" );
+    if( !path_env ) {
+        return;
+    }
+
+    String rem = string_from_cstr( path_env );
+    while( rem.len ) {
+        String dir = rem;
+        usize  sep = 0;
+        if( string_find( rem, PROCESS_RESOLVE_PATH_SEPARATOR, &sep ) ) {
+            dir.len = sep;
+            rem     = string_advance_by( rem, sep + 1 );
+        } else {
+            rem = string_advance_by( rem, rem.len );
+        }
+        if( !dir.len ) {
+            continue;
+        }
+
+        ScratchScope scope = scratch_begin();
+        const char* dir_c = local_fmt( "%.*s", (int)dir.len, dir.cc );
+
+        WalkDirectory wd;
+        memory_zero( &wd, sizeof(wd) );
+        if( path_exists( dir_c ) && path_walk_dir( dir_c, false, false, &wd ) ) {
+            for( usize i = 0; i < wd.count; ++i ) {
+                String full = wd.paths[i];
+                String name = full;
+                usize  last = 0;
+                if( string_find_rev( name, '/', &last ) ) {
+                    name = string_advance_by( name, last + 1 );
+                }
+                if( name.len ) {
+                    // full.cc is nul-terminated inside the walk buffer.
+                    process_resolve_insert( name, full, false );
+                }
+            }
+            path_walk_free( &wd );
+        }
+        scratch_end( scope );
+    }
+}
+const char* process_resolve( const char* process_name ) {
+    assertion( process_name, "null process name!" );
+    String name = string_from_cstr( process_name );
+
+#if defined(PLATFORM_WINDOWS)
+    b32 has_separator =
+        string_find( name, '/', 0 ) || string_find( name, '\\', 0 );
+#else
+    b32 has_separator = string_find( name, '/', 0 );
+#endif
+    if( has_separator ) {
+        return process_resolve_executable( process_name )
+            ? process_name : NULL;
+    }
+
+    struct ProcessResolver* rs = &global_process_resolver;
+    const char* res = NULL;
+    process_resolve_lock();
+    for( ;; ) {
+        usize at    = 0;
+        b32   found = process_resolve_find( name, &at );
+#if defined(PLATFORM_WINDOWS)
+        if( !found && !string_find( name, '.', 0 ) ) {
+            static const char* extensions[] = { ".exe", ".cmd", ".bat" };
+            for( usize i = 0; i < static_array_len( extensions ); ++i ) {
+                ScratchScope scope = scratch_begin();
+                const char* key =
+                    local_fmt( "%s%s", process_name, extensions[i] );
+                found = process_resolve_find( string_from_cstr( key ), &at );
+                scratch_end( scope );
+                if( found ) {
+                    break;
+                }
+            }
+        }
+#endif
+        if( found ) {
+            struct ProcessResolveEntry* entry = rs->entries + at;
+            const char* resolved = rs->buf + entry->path_offset;
+            if( process_resolve_executable( resolved ) ) {
+                entry->hit = true;
+                res = resolved;
+                break;
+            }
+            // tool moved since it was indexed or persisted.
+            darray_remove( rs->entries, at );
+        }
+        if( rs->scanned ) {
+            break;
+        }
+        process_resolve_scan();
+    }
+    process_resolve_unlock();
+    return res;
+}
+b32 process_in_path( const char* process_name ) {
+    return process_resolve( process_name ) != NULL;
+}
+b32 process_resolve_load( const char* path ) {
+    const char* path_env = getenv( "PATH" );
+    if( !path_env ) {
+        return false;
+    }
+    u64 path_hash = hash_buffer( strlen( path_env ), path_env );
+
+    FileMap map;
+    if( !file_map( path, &map ) ) {
+        return false;
+    }
+
+    b32 res = false;
+    String rem = map.view;
+
+    String header = rem;
+    usize  eol    = 0;
+    if( string_find( rem, '\n', &eol ) ) {
+        header.len = eol;
+        rem        = string_advance_by( rem, eol + 1 );
+
+        usize space = 0;
+        u64   saved_hash = 0;
+        if( string_find( header, ' ', &space ) ) {
+            String tag = header;
+            tag.len    = space;
+            saved_hash = strtoull( header.cc + space + 1, NULL, 16 );
+            res = string_cmp( tag, string_text( PROCESS_RESOLVE_HEADER ) ) &&
+                saved_hash == path_hash;
+        }
+    }
+
+    process_resolve_lock();
+    while( res && rem.len ) {
+        String line = rem;
+        eol         = 0;
+        if( string_find( rem, '\n', &eol ) ) {
+            line.len = eol;
+            rem      = string_advance_by( rem, eol + 1 );
+        } else {
+            rem = string_advance_by( rem, rem.len );
+        }
+
+        line = string_trim_surrounding_whitespace( line );
+        if( !line.len ) {
+            continue;
+        }
+
+        usize space = 0;
+        if( !string_find( line, ' ', &space ) ) {
+            res = false;
+            break;
+        }
+        String name = line;
+        name.len    = space;
+        String full = string_trim_leading_whitespace(
+            string_advance_by( line, space + 1 ) );
+        if( !name.len || !full.len ) {
+            res = false;
+            break;
+        }
+        res = process_resolve_insert( name, full, true );
+    }
+    process_resolve_unlock();
+
+    file_unmap( &map );
+    return res;
+}
+b32 process_resolve_save( const char* path ) {
+    struct ProcessResolver* rs = &global_process_resolver;
+    const char* path_env = getenv( "PATH" );
+    if( !path_env ) {
+        return false;
+    }
+    u64 path_hash = hash_buffer( strlen( path_env ), path_env );
+
+    FD file;
+    if( !fd_open(
+        path,
+        path_exists( path )
+            ? (FOPEN_WRITE | FOPEN_TRUNCATE) : (FOPEN_WRITE | FOPEN_CREATE),
+        &file )
+    ) {
+        cb_error( "process_resolve_save: failed to open '%s'!", path );
+        return false;
+    }
+
+    b32 res = fd_write_fmt(
+        &file, PROCESS_RESOLVE_HEADER " %llx\n",
+        (unsigned long long)path_hash );
+    process_resolve_lock();
+    usize count = rs->entries ? darray_len( rs->entries ) : 0;
+    for( usize i = 0; res && i < count; ++i ) {
+        struct ProcessResolveEntry* entry = rs->entries + i;
+        if( !entry->hit ) {
+            continue;
+        }
+        String name = process_resolve_entry_name( entry );
+        res = fd_write_fmt(
+            &file, "%.*s %s\n",
+            (int)name.len, name.cc, rs->buf + entry->path_offset );
+    }
+    process_resolve_unlock();
+
+    fd_close( &file );
+    if( !res ) {
+        cb_error( "process_resolve_save: failed to write '%s'!", path );
+    }
+    return res;
+}
+
+#define BUILD_CACHE_MANIFEST_HEADER "cbuild-cache-manifest-1"
+
+static u64 build_cache_hash_command( const Command* opt_cmd ) {
+    if( !opt_cmd ) {
+        return 0;
+    }
+    DString* flat = command_flatten_dstring( opt_cmd );
+    if( !flat ) {
+        return 0;
+    }
+    u64 hash = hash_buffer( dstring_len( flat ), flat );
+    dstring_free( flat );
+    return hash;
+}
+static void build_cache_entry_free( BuildCacheEntry* entry ) {
+    if( entry->target ) {
+        dstring_free( entry->target );
+    }
+    if( entry->inputs ) {
+        for( usize i = 0; i < darray_len( entry->inputs ); ++i ) {
+            dstring_free( entry->inputs[i].path );
+        }
+        darray_free( entry->inputs );
+    }
+    memory_zero( entry, sizeof(*entry) );
+}
+static BuildCacheEntry* build_cache_find(
+    BuildCache* cache, String target
+) {
+    for( usize i = 0; i < darray_len( cache->entries ); ++i ) {
+        BuildCacheEntry* entry = cache->entries + i;
+        if( string_cmp( string_from_dstring( entry->target ), target ) ) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+static b32 build_cache_parse( BuildCache* cache, String manifest ) {
+    String rem = manifest;
+
+    // skip header, already validated by caller.
+    string_split_char( rem, '\n', false, 0, &rem );
+
+    BuildCacheEntry* entry = NULL;
+    while( rem.len ) {
+        String line = rem;
+        usize  eol  = 0;
+        if( string_find( rem, '\n', &eol ) ) {
+            line.len = eol;
+            rem      = string_advance_by( rem, eol + 1 );
+        } else {
+            rem = string_advance_by( rem, rem.len );
+        }
+
+        line = string_trim_surrounding_whitespace( line );
+        if( !line.len ) {
+            continue;
+        }
+
+        if( string_cmp( string_truncate( line, 7 ), string_text( "target " ) ) ) {
+            line = string_advance_by( line, 7 );
+
+            char* end      = NULL;
+            u64   cmd_hash = strtoull( line.cc, &end, 16 );
+            String path    =
+                string_trim_leading_whitespace(
+                    string_advance_by( line, end - line.cc ) );
+            if( !path.len ) {
+                return false;
+            }
+
+            BuildCacheEntry new_entry;
+            memory_zero( &new_entry, sizeof(new_entry) );
+            new_entry.target   = dstring_from_string( path );
+            new_entry.cmd_hash = cmd_hash;
+            new_entry.inputs   = darray_empty( sizeof(BuildCacheInput), 4 );
+            if( !new_entry.target || !new_entry.inputs ) {
+                build_cache_entry_free( &new_entry );
+                return false;
+            }
+
+            Darray(BuildCacheEntry) _new =
+                darray_push( cache->entries, &new_entry );
+            if( !_new ) {
+                build_cache_entry_free( &new_entry );
+                return false;
+            }
+            cache->entries = _new;
+            entry = cache->entries + (darray_len( cache->entries ) - 1);
+            continue;
+        }
+
+        if( string_cmp( string_truncate( line, 6 ), string_text( "input " ) ) ) {
+            if( !entry ) {
+                return false;
+            }
+            line = string_advance_by( line, 6 );
+
+            char* end    = NULL;
+            u64   mtime  = strtoull( line.cc, &end, 10 );
+            line         = string_trim_leading_whitespace(
+                string_advance_by( line, end - line.cc ) );
+            u64   hash   = strtoull( line.cc, &end, 16 );
+            String path  = string_trim_leading_whitespace(
+                string_advance_by( line, end - line.cc ) );
+            if( !path.len ) {
+                return false;
+            }
+
+            BuildCacheInput input;
+            memory_zero( &input, sizeof(input) );
+            input.path        = dstring_from_string( path );
+            input.time_modify = (time_t)mtime;
+            input.hash        = hash;
+            if( !input.path ) {
+                return false;
+            }
+
+            Darray(BuildCacheInput) _new = darray_push( entry->inputs, &input );
+            if( !_new ) {
+                dstring_free( input.path );
+                return false;
+            }
+            entry->inputs = _new;
+            continue;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+b32 build_cache_open( const char* manifest_path, BuildCache* out_cache ) {
+    assertion( manifest_path, "no manifest path provided!" );
+    assertion( out_cache, "no cache provided!" );
+
+    memory_zero( out_cache, sizeof(*out_cache) );
+    out_cache->path = dstring_from_cstr( manifest_path );
+    if( !out_cache->path ) {
+        return false;
+    }
+    out_cache->entries = darray_empty( sizeof(BuildCacheEntry), 4 );
+    if( !out_cache->entries ) {
+        dstring_free( out_cache->path );
+        return false;
+    }
+
+    if( !path_exists( manifest_path ) ) {
+        return true;
+    }
+
+    FD file;
+    if( !fd_open( manifest_path, FOPEN_READ, &file ) ) {
+        build_cache_free( out_cache );
+        return false;
+    }
+
+    usize    size = fd_query_size( &file );
+    DString* buf  = dstring_empty( size + 1 );
+    if( !buf ) {
+        fd_close( &file );
+        build_cache_free( out_cache );
+        return false;
+    }
+    if( !fd_read( &file, size, buf, 0 ) ) {
+        fd_close( &file );
+        dstring_free( buf );
+        build_cache_free( out_cache );
+        return false;
+    }
+    dstring_set_len( buf, size );
+    fd_close( &file );
 
-    WalkDirectory wd;
-    memory_zero( &wd, sizeof(wd) );
+    String manifest = string_from_dstring( buf );
+    if( !string_cmp(
+        string_truncate( manifest, sizeof(BUILD_CACHE_MANIFEST_HEADER) - 1 ),
+        string_text( BUILD_CACHE_MANIFEST_HEADER ) )
+    ) {
+        cb_error(
+            "build_cache_open: '%s' is not a cbuild manifest!", manifest_path );
+        dstring_free( buf );
+        build_cache_free( out_cache );
+        return false;
+    }
 
-    if( !path_walk_dir( path, true, false, &wd ) ) {
-        cb_error( "dir_remove: failed to walk directory '%s'!", path );
+    b32 res = build_cache_parse( out_cache, manifest );
+    dstring_free( buf );
+
+    if( !res ) {
+        cb_error(
+            "build_cache_open: failed to parse manifest '%s'!", manifest_path );
+        build_cache_free( out_cache );
         return false;
     }
+    return true;
+}
+b32 build_cache_is_dirty(
+    BuildCache* cache, const char* target, const Command* opt_cmd,
+    usize input_count, const char** inputs
+) {
+    assertion( cache && cache->entries, "cache is null!" );
+    assertion( target, "no target provided!" );
 
-    for( usize i = 0; i < wd.count; ++i ) {
-        if( !file_remove( wd.paths[i].cc ) ) {
-            cb_error( "dir_remove: failed to remove file '%s'!", wd.paths[i].cc );
+    BuildCacheEntry* entry =
+        build_cache_find( cache, string_from_cstr( target ) );
+    if( !entry ) {
+        return true;
+    }
+    if( !path_exists( target ) ) {
+        return true;
+    }
+    if( entry->cmd_hash != build_cache_hash_command( opt_cmd ) ) {
+        return true;
+    }
+    if( darray_len( entry->inputs ) != input_count ) {
+        return true;
+    }
 
-            path_walk_free( &wd );
-            return false;
+    if( !input_count ) {
+        return false;
+    }
+
+    // NOTE(alicia): batched so the freshness sweep doesn't re-walk
+    // shared directory components once per input.
+    FileStat* stats = memory_alloc( sizeof(FileStat) * input_count );
+    if( !stats ) {
+        return true;
+    }
+    file_stat_batch( input_count, inputs, stats );
+
+    b32 dirty = false;
+    for( usize i = 0; i < input_count; ++i ) {
+        BuildCacheInput* input = entry->inputs + i;
+        if( !string_cmp(
+            string_from_dstring( input->path ), string_from_cstr( inputs[i] ) )
+        ) {
+            dirty = true;
+            break;
+        }
+        if( !stats[i].exists ) {
+            dirty = true;
+            break;
+        }
+
+        time_t modify = stats[i].time_modify;
+        if( modify == input->time_modify ) {
+            continue;
+        }
+
+        // mtime churned, check if contents actually changed.
+        u64 hash = 0;
+        if( !hash_file( inputs[i], &hash ) ) {
+            dirty = true;
+            break;
+        }
+        if( hash != input->hash ) {
+            dirty = true;
+            break;
         }
+        // contents are the same, remember new mtime
+        // to skip hashing next time around.
+        input->time_modify = modify;
     }
 
-    path_walk_free( &wd );
+    memory_free( stats, sizeof(FileStat) * input_count );
+    return dirty;
+}
+b32 build_cache_update(
+    BuildCache* cache, const char* target, const Command* opt_cmd,
+    usize input_count, const char** inputs
+) {
+    assertion( cache && cache->entries, "cache is null!" );
+    assertion( target, "no target provided!" );
 
-    if( !path_walk_dir( path, true, true, &wd ) ) {
-        cb_error( "dir_remove: failed to walk directory '%s'!", path );
+    BuildCacheEntry entry;
+    memory_zero( &entry, sizeof(entry) );
+
+    entry.target = dstring_from_cstr( target );
+    if( !entry.target ) {
+        return false;
+    }
+    entry.cmd_hash = build_cache_hash_command( opt_cmd );
+    entry.inputs   =
+        darray_empty( sizeof(BuildCacheInput), input_count ? input_count : 1 );
+    if( !entry.inputs ) {
+        dstring_free( entry.target );
         return false;
     }
 
-    for( usize i = 0; i < wd.count; ++i ) {
-        if( !dir_remove_internal( wd.paths[i].cc ) ) {
-            cb_error( "dir_remove: failed to remove dir '%s'!", wd.paths[i].cc );
+    u64* hashes = NULL;
+    if( input_count ) {
+        hashes = memory_alloc( sizeof(u64) * input_count );
+        if( !hashes || !hash_file_batch( input_count, inputs, hashes ) ) {
+            if( hashes ) {
+                memory_free( hashes, sizeof(u64) * input_count );
+            }
+            build_cache_entry_free( &entry );
+            return false;
+        }
+    }
 
-            path_walk_free( &wd );
+    for( usize i = 0; i < input_count; ++i ) {
+        BuildCacheInput input;
+        memory_zero( &input, sizeof(input) );
+
+        input.path = dstring_from_cstr( inputs[i] );
+        if( !input.path ) {
+            memory_free( hashes, sizeof(u64) * input_count );
+            build_cache_entry_free( &entry );
             return false;
         }
+        input.time_modify = file_query_time_modify( inputs[i] );
+        input.hash        = hashes[i];
+
+        expect( darray_try_push( entry.inputs, &input ),
+            "miscalculated input count!" );
+    }
+    if( hashes ) {
+        memory_free( hashes, sizeof(u64) * input_count );
     }
 
-    path_walk_free( &wd );
-    return dir_remove_internal( path );
-}
+    BuildCacheEntry* existing =
+        build_cache_find( cache, string_from_cstr( target ) );
+    if( existing ) {
+        build_cache_entry_free( existing );
+        *existing = entry;
+        return true;
+    }
 
-b32 fd_write_fmt_va( FD* file, const char* format, va_list va ) {
-    char* formatted = local_fmt_va( format, va );
-    return fd_write( file, strlen( formatted ), formatted, 0 );
-}
-b32 fd_write_fmt( FD* file, const char* format, ... ) {
-    va_list va;
-    va_start( va, format );
-    b32 res = fd_write_fmt_va( file, format, va );
-    va_end( va );
-    return res;
+    Darray(BuildCacheEntry) _new = darray_push( cache->entries, &entry );
+    if( !_new ) {
+        build_cache_entry_free( &entry );
+        return false;
+    }
+    cache->entries = _new;
+    return true;
 }
+b32 build_cache_save( BuildCache* cache ) {
+    assertion( cache && cache->path, "cache is null!" );
+
+    FD file;
+    if( !fd_open(
+        cache->path,
+        path_exists( cache->path )
+            ? (FOPEN_WRITE | FOPEN_TRUNCATE) : (FOPEN_WRITE | FOPEN_CREATE),
+        &file )
+    ) {
+        cb_error( "build_cache_save: failed to open '%s'!", cache->path );
+        return false;
+    }
 
-void* darray_empty( usize stride, usize cap ) {
-    struct DynamicArray* res = memory_alloc( sizeof(*res) + (stride * cap) );
+    b32 res = fd_write_fmt( &file, BUILD_CACHE_MANIFEST_HEADER "\n" );
+    for( usize i = 0; res && i < darray_len( cache->entries ); ++i ) {
+        BuildCacheEntry* entry = cache->entries + i;
+        res = fd_write_fmt(
+            &file, "target %llx %s\n",
+            (unsigned long long)entry->cmd_hash, entry->target );
+
+        for( usize j = 0; res && j < darray_len( entry->inputs ); ++j ) {
+            BuildCacheInput* input = entry->inputs + j;
+            res = fd_write_fmt(
+                &file, "input %llu %llx %s\n",
+                (unsigned long long)input->time_modify,
+                (unsigned long long)input->hash, input->path );
+        }
+    }
+
+    fd_close( &file );
     if( !res ) {
-        return NULL;
+        cb_error( "build_cache_save: failed to write '%s'!", cache->path );
     }
-    res->stride = stride;
-    res->cap    = cap;
-    return res->buf;
+    return res;
 }
-void* darray_from_array( usize stride, usize len, const void* buf ) {
-    struct DynamicArray* res = darray_head( darray_empty( stride, len + 2 ) );
-    if( !res ) {
-        return NULL;
+void build_cache_free( BuildCache* cache ) {
+    if( cache ) {
+        if( cache->entries ) {
+            for( usize i = 0; i < darray_len( cache->entries ); ++i ) {
+                build_cache_entry_free( cache->entries + i );
+            }
+            darray_free( cache->entries );
+        }
+        if( cache->path ) {
+            dstring_free( cache->path );
+        }
+        memory_zero( cache, sizeof(*cache) );
     }
+}
 
-    memory_copy( res->buf, buf, len * stride );
-    res->len = len;
+#define DEP_INDEX_HEADER "cbuild-dep-index-1"
 
-    return res->buf;
+static void dep_index_entry_free( DepIndexEntry* entry ) {
+    if( entry ) {
+        if( entry->path ) {
+            dstring_free( entry->path );
+        }
+        if( entry->includes ) {
+            darray_free( entry->includes );
+        }
+        memory_zero( entry, sizeof(*entry) );
+    }
 }
-usize darray_static_memory_requirement( usize stride, usize cap ) {
-    return (stride * cap) + sizeof(struct DynamicArray);
+static b32 dep_index_find( DepIndex* index, String path, usize* out_index ) {
+    for( usize i = 0; i < darray_len( index->entries ); ++i ) {
+        if( string_cmp(
+            string_from_dstring( index->entries[i].path ), path )
+        ) {
+            *out_index = i;
+            return true;
+        }
+    }
+    return false;
 }
-void* darray_static( usize stride, usize cap, void* buf ) {
-    struct DynamicArray* res = buf;
-    res->stride = stride;
-    res->cap    = cap;
-    res->len    = 0;
-    return res->buf;
+static b32 dep_index_get( DepIndex* index, String path, usize* out_index ) {
+    if( dep_index_find( index, path, out_index ) ) {
+        return true;
+    }
+
+    DepIndexEntry entry;
+    memory_zero( &entry, sizeof(entry) );
+    entry.path = dstring_from_string( path );
+    if( !entry.path ) {
+        return false;
+    }
+    entry.includes = darray_empty( sizeof(u32), 4 );
+    if( !entry.includes ) {
+        dstring_free( entry.path );
+        return false;
+    }
+
+    Darray(DepIndexEntry) _new = darray_push( index->entries, &entry );
+    if( !_new ) {
+        dep_index_entry_free( &entry );
+        return false;
+    }
+    index->entries = _new;
+    *out_index = darray_len( index->entries ) - 1;
+    return true;
 }
-void* darray_join( usize stride,
-    usize lhs_len, const void* lhs, usize rhs_len, const void* rhs
+static b32 dep_index_next_include(
+    String* rem, String* out_include, b32* out_quoted
 ) {
-    struct DynamicArray* res =
-        darray_head( darray_empty( stride, lhs_len + rhs_len + 2 ) );
-    if( !res ) {
-        return NULL;
-    }
+    while( rem->len ) {
+        String line = *rem;
+        usize  eol  = 0;
+        if( string_find( *rem, '\n', &eol ) ) {
+            line.len = eol;
+            *rem     = string_advance_by( *rem, eol + 1 );
+        } else {
+            *rem = string_advance_by( *rem, rem->len );
+        }
 
-    memory_copy( res->buf, lhs, stride * lhs_len );
-    memory_copy( res->buf + (stride * lhs_len), rhs, rhs_len );
-    res->len = lhs_len + rhs_len;
+        line = string_trim_leading_whitespace( line );
+        if( !line.len || line.cc[0] != '#' ) {
+            continue;
+        }
+        line = string_trim_leading_whitespace( string_advance( line ) );
+        if( !string_cmp(
+            string_truncate( line, 7 ), string_text( "include" ) )
+        ) {
+            continue;
+        }
+        line = string_trim_leading_whitespace( string_advance_by( line, 7 ) );
+        if( !line.len || (line.cc[0] != '"' && line.cc[0] != '<') ) {
+            continue;
+        }
 
-    return res;
+        char close = line.cc[0] == '"' ? '"' : '>';
+        line       = string_advance( line );
+
+        usize end = 0;
+        if( !string_find( line, close, &end ) || !end ) {
+            continue;
+        }
+
+        *out_include = string_truncate( line, end );
+        *out_quoted  = close == '"';
+        return true;
+    }
+    return false;
 }
-void* darray_from_filter(
-    usize stride, usize len, const void* src,
-    DarrayFilterFN* filter, void* filter_params
+static b32 dep_index_resolve(
+    DepIndex* index, String include, String dir, b32 quoted,
+    DString** out_path
 ) {
-    const u8* src_bytes = src;
+    if( quoted && dir.len ) {
+        DString* path = dstring_fmt(
+            "%.*s/%.*s", (int)dir.len, dir.cc, (int)include.len, include.cc );
+        if( path ) {
+            if( path_exists( path ) ) {
+                *out_path = path;
+                return true;
+            }
+            dstring_free( path );
+        }
+    }
+    for( usize i = 0; i < darray_len( index->include_dirs ); ++i ) {
+        DString* path = dstring_fmt(
+            "%s/%.*s", index->include_dirs[i],
+            (int)include.len, include.cc );
+        if( path ) {
+            if( path_exists( path ) ) {
+                *out_path = path;
+                return true;
+            }
+            dstring_free( path );
+        }
+    }
+    return false;
+}
+static b32 dep_index_scan_entry( DepIndex* index, usize entry_index ) {
+    DepIndexEntry* entry = index->entries + entry_index;
+    if( entry->mark == index->mark ) {
+        return true;
+    }
+    entry->mark = index->mark;
 
-    void* res = darray_empty( stride, 10 );
-    if( !res ) {
-        return NULL;
+    if( !path_exists( entry->path ) ) {
+        // header was deleted, forget its edges.
+        entry->time_modify = 0;
+        darray_clear( entry->includes );
+        return true;
     }
 
-    for( usize i = 0; i < len; ++i ) {
-        const u8* item = src_bytes + (stride * i);
-        if( filter( i, stride, item, filter_params ) ) {
-            void* _new = darray_push( res, item );
+    time_t modify = file_query_time_modify( entry->path );
+    if( modify != entry->time_modify ) {
+        FileMap map;
+        if( !file_map( entry->path, &map ) ) {
+            return false;
+        }
+
+        darray_clear( entry->includes );
+
+        String dir = string_from_dstring( entry->path );
+        usize  sep = 0;
+        if( string_find_rev( dir, '/', &sep ) ) {
+            dir.len = sep;
+        } else {
+            dir.len = 0;
+        }
+
+        String rem = map.view;
+        String include;
+        b32    quoted = false;
+        while( dep_index_next_include( &rem, &include, &quoted ) ) {
+            DString* resolved = NULL;
+            if( !dep_index_resolve( index, include, dir, quoted, &resolved ) ) {
+                // system header or otherwise not ours to track.
+                continue;
+            }
+
+            usize child = 0;
+            b32   ok    =
+                dep_index_get( index, string_from_dstring( resolved ), &child );
+            dstring_free( resolved );
+            if( !ok ) {
+                file_unmap( &map );
+                return false;
+            }
+            // entries may have grown.
+            entry = index->entries + entry_index;
+
+            b32 already = false;
+            for( usize i = 0; i < darray_len( entry->includes ); ++i ) {
+                if( entry->includes[i] == (u32)child ) {
+                    already = true;
+                    break;
+                }
+            }
+            if( already ) {
+                continue;
+            }
+
+            u32 child_index  = child;
+            Darray(u32) _new = darray_push( entry->includes, &child_index );
             if( !_new ) {
-                darray_free( res );
-                return NULL;
+                file_unmap( &map );
+                return false;
+            }
+            entry->includes = _new;
+        }
+        file_unmap( &map );
+
+        entry->time_modify = modify;
+    }
+
+    for( usize i = 0; i < darray_len( entry->includes ); ++i ) {
+        usize child = entry->includes[i];
+        if( !dep_index_scan_entry( index, child ) ) {
+            return false;
+        }
+        // recursion may have grown entries.
+        entry = index->entries + entry_index;
+    }
+    return true;
+}
+static time_t dep_index_entry_time_modify( DepIndex* index, usize entry_index ) {
+    DepIndexEntry* entry = index->entries + entry_index;
+    if( entry->mark == index->mark ) {
+        return 0;
+    }
+    entry->mark = index->mark;
+
+    time_t res = entry->time_modify;
+    for( usize i = 0; i < darray_len( entry->includes ); ++i ) {
+        time_t include_modify =
+            dep_index_entry_time_modify( index, entry->includes[i] );
+        if( include_modify > res ) {
+            res = include_modify;
+        }
+    }
+    return res;
+}
+static b32 dep_index_parse( DepIndex* index, String text ) {
+    String rem = text;
+
+    // skip header, already validated by caller.
+    string_split_char( rem, '\n', false, 0, &rem );
+
+    DepIndexEntry* entry = NULL;
+    while( rem.len ) {
+        String line = rem;
+        usize  eol  = 0;
+        if( string_find( rem, '\n', &eol ) ) {
+            line.len = eol;
+            rem      = string_advance_by( rem, eol + 1 );
+        } else {
+            rem = string_advance_by( rem, rem.len );
+        }
+
+        line = string_trim_surrounding_whitespace( line );
+        if( !line.len ) {
+            continue;
+        }
+
+        if( string_cmp( string_truncate( line, 5 ), string_text( "file " ) ) ) {
+            line = string_advance_by( line, 5 );
+
+            char* end    = NULL;
+            u64   mtime  = strtoull( line.cc, &end, 10 );
+            String path  =
+                string_trim_leading_whitespace(
+                    string_advance_by( line, end - line.cc ) );
+            if( !path.len ) {
+                return false;
+            }
+
+            DepIndexEntry new_entry;
+            memory_zero( &new_entry, sizeof(new_entry) );
+            new_entry.path        = dstring_from_string( path );
+            new_entry.time_modify = (time_t)mtime;
+            new_entry.includes    = darray_empty( sizeof(u32), 4 );
+            if( !new_entry.path || !new_entry.includes ) {
+                dep_index_entry_free( &new_entry );
+                return false;
+            }
+
+            Darray(DepIndexEntry) _new =
+                darray_push( index->entries, &new_entry );
+            if( !_new ) {
+                dep_index_entry_free( &new_entry );
+                return false;
+            }
+            index->entries = _new;
+            entry = index->entries + (darray_len( index->entries ) - 1);
+            continue;
+        }
+
+        if( string_cmp( string_truncate( line, 4 ), string_text( "inc " ) ) ) {
+            if( !entry ) {
+                return false;
+            }
+            line = string_advance_by( line, 4 );
+
+            u32 include = (u32)strtoull( line.cc, NULL, 10 );
+
+            Darray(u32) _new = darray_push( entry->includes, &include );
+            if( !_new ) {
+                return false;
+            }
+            entry->includes = _new;
+            continue;
+        }
+
+        return false;
+    }
+
+    // edges may reference entries that come later in the file,
+    // so bounds can only be validated once everything is parsed.
+    for( usize i = 0; i < darray_len( index->entries ); ++i ) {
+        DepIndexEntry* e = index->entries + i;
+        for( usize j = 0; j < darray_len( e->includes ); ++j ) {
+            if( e->includes[j] >= darray_len( index->entries ) ) {
+                return false;
             }
         }
     }
 
-    return res;
+    return true;
 }
+b32 dep_index_open( const char* index_path, DepIndex* out_index ) {
+    assertion( index_path, "no index path provided!" );
+    assertion( out_index, "no index provided!" );
 
-void* darray_grow( void* darray, usize amount ) {
-    struct DynamicArray* res = darray_head( darray );
-    usize old_size = (res->stride * res->cap) + sizeof(*res);
-    usize new_size = (res->stride * amount) + old_size;
-
-    res = memory_realloc( res, old_size, new_size );
-    if( !res ) {
-        return NULL;
+    memory_zero( out_index, sizeof(*out_index) );
+    out_index->path = dstring_from_cstr( index_path );
+    if( !out_index->path ) {
+        return false;
+    }
+    out_index->include_dirs = darray_empty( sizeof(DString*), 4 );
+    if( !out_index->include_dirs ) {
+        dstring_free( out_index->path );
+        return false;
+    }
+    out_index->entries = darray_empty( sizeof(DepIndexEntry), 16 );
+    if( !out_index->entries ) {
+        darray_free( out_index->include_dirs );
+        dstring_free( out_index->path );
+        return false;
     }
 
-    res->cap += amount;
-    return res->buf;
-}
-void* darray_clone( const void* darray ) {
-    return darray_from_array(
-        darray_stride( darray ), darray_len( darray ), darray );
-}
-void darray_clear( void* darray ) {
-    struct DynamicArray* head = darray_head( darray );
-    memory_zero( head->buf, head->len * head->stride );
-    head->len = 0;
-}
-void* darray_set_len( void* darray, usize len ) {
-    if( len > darray_cap( darray ) ) {
-        usize diff = len - darray_cap( darray );
-
-        struct DynamicArray* head = darray_head( darray_grow( darray, diff ) );
-        if( !head ) {
-            return NULL;
-        }
+    if( !path_exists( index_path ) ) {
+        return true;
+    }
 
-        head->len = len;
-        return head->buf;
-    } else if( len > darray_len( darray ) ) {
-        struct DynamicArray* head = darray_head( darray );
-        usize diff = head->len - len;
-        memory_zero( head->buf + len, head->stride * diff );
-        head->len = diff;
+    FD file;
+    if( !fd_open( index_path, FOPEN_READ, &file ) ) {
+        dep_index_free( out_index );
+        return false;
+    }
 
-        return head->buf;
-    } else {
-        darray_truncate( darray, len );
-        return darray;
+    usize    size = fd_query_size( &file );
+    DString* buf  = dstring_empty( size + 1 );
+    if( !buf ) {
+        fd_close( &file );
+        dep_index_free( out_index );
+        return false;
     }
-}
-void darray_truncate( void* darray, usize max ) {
-    struct DynamicArray* head = darray_head( darray );
-    if( max >= head->len ) {
-        return;
+    if( !fd_read( &file, size, buf, 0 ) ) {
+        fd_close( &file );
+        dstring_free( buf );
+        dep_index_free( out_index );
+        return false;
     }
-    usize diff = head->len - max;
-    memory_zero( head->buf + max, head->stride * diff );
-    head->len = max;
-}
-void darray_trim( void* darray, usize amount ) {
-    struct DynamicArray* head = darray_head( darray );
-    darray_truncate( head->buf, amount > head->len ? 0 : head->len - amount );
-}
-b32 darray_try_push( void* darray, const void* item ) {
-    struct DynamicArray* head = darray_head( darray );
-    if( head->len == head->cap ) {
+    dstring_set_len( buf, size );
+    fd_close( &file );
+
+    String text = string_from_dstring( buf );
+    if( !string_cmp(
+        string_truncate( text, sizeof(DEP_INDEX_HEADER) - 1 ),
+        string_text( DEP_INDEX_HEADER ) )
+    ) {
+        cb_error(
+            "dep_index_open: '%s' is not a cbuild dependency index!",
+            index_path );
+        dstring_free( buf );
+        dep_index_free( out_index );
         return false;
     }
 
-    memory_copy( head->buf + (head->stride * head->len), item, head->stride );
-    head->len++;
+    b32 res = dep_index_parse( out_index, text );
+    dstring_free( buf );
 
+    if( !res ) {
+        cb_error(
+            "dep_index_open: failed to parse index '%s'!", index_path );
+        dep_index_free( out_index );
+        return false;
+    }
     return true;
 }
-b32 darray_try_emplace( void* darray, const void* item, usize at ) {
-    struct DynamicArray* head = darray_head( darray );
-    if( head->len == head->cap ) {
+b32 dep_index_add_include_dir( DepIndex* index, const char* dir ) {
+    assertion( index && index->include_dirs, "index is null!" );
+    assertion( dir, "no directory provided!" );
+
+    DString* path = dstring_from_cstr( dir );
+    if( !path ) {
         return false;
     }
-    if( at >= head->len ) {
-        cb_warn(
-            "darray_emplace: attempted to emplace past darray bounds! "
-            "len: %zu index: %zu", head->len, at );
+    Darray(DString*) _new = darray_push( index->include_dirs, &path );
+    if( !_new ) {
+        dstring_free( path );
         return false;
     }
-
-    memory_move(
-        head->buf + ( head->stride * ( at + 1 ) ),
-        head->buf + ( head->stride * at ),
-        head->stride * ( ( head->len + 1 ) - at ) );
-    memory_copy( head->buf + ( head->stride * at ), item, head->stride );
-    head->len++;
-
+    index->include_dirs = _new;
     return true;
 }
-b32 darray_try_insert( void* darray, usize count, const void* items, usize at ) {
-    struct DynamicArray* head = darray_head( darray );
-    if( head->len + count > head->cap ) {
+b32 dep_index_scan( DepIndex* index, const char* path ) {
+    assertion( index && index->entries, "index is null!" );
+    assertion( path, "no path provided!" );
+
+    if( !path_exists( path ) ) {
         return false;
     }
-    if( at >= head->len ) {
-        cb_warn(
-            "darray_insert: attempted to insert past darray bounds! "
-            "len: %zu index: %zu", head->len, at );
+
+    usize entry_index = 0;
+    if( !dep_index_get( index, string_from_cstr( path ), &entry_index ) ) {
         return false;
     }
-
-    memory_move(
-        head->buf + ( head->stride * ( at + count ) ),
-        head->buf + ( head->stride * at ),
-        head->stride * ( ( head->len + 1 ) - at ) );
-    memory_copy( head->buf + ( head->stride * at ), items, head->stride * count );
-    head->len += count;
-
-    return true;
+    index->mark++;
+    return dep_index_scan_entry( index, entry_index );
 }
-b32 darray_try_append( void* darray, usize count, const void* items ) {
-    struct DynamicArray* head = darray_head( darray );
-    if( head->len + count > head->cap ) {
-        return false;
+time_t dep_index_time_modify( DepIndex* index, const char* path ) {
+    if( !dep_index_scan( index, path ) ) {
+        return 0;
     }
 
-    memory_copy(
-        head->buf + (head->stride * head->len),
-        items, head->stride * count );
-    head->len += count;
+    usize entry_index = 0;
+    expect( dep_index_find( index, string_from_cstr( path ), &entry_index ),
+        "scan succeeded but entry is missing!" );
 
-    return true;
+    index->mark++;
+    return dep_index_entry_time_modify( index, entry_index );
 }
-b32 darray_pop( void* darray, void* opt_out_item ) {
-    struct DynamicArray* head = darray_head( darray );
-    if( !head->len ) {
+b32 dep_index_save( DepIndex* index ) {
+    assertion( index && index->path, "index is null!" );
+
+    FD file;
+    if( !fd_open(
+        index->path,
+        path_exists( index->path )
+            ? (FOPEN_WRITE | FOPEN_TRUNCATE) : (FOPEN_WRITE | FOPEN_CREATE),
+        &file )
+    ) {
+        cb_error( "dep_index_save: failed to open '%s'!", index->path );
         return false;
     }
 
-    head->len--;
-    if( opt_out_item ) {
-        memory_copy(
-            opt_out_item, head->buf + (head->stride * head->len), head->stride );
-    }
+    b32 res = fd_write_fmt( &file, DEP_INDEX_HEADER "\n" );
+    for( usize i = 0; res && i < darray_len( index->entries ); ++i ) {
+        DepIndexEntry* entry = index->entries + i;
+        res = fd_write_fmt(
+            &file, "file %llu %s\n",
+            (unsigned long long)entry->time_modify, entry->path );
 
-    memory_zero( head->buf + (head->stride * head->len), head->stride );
-    return true;
-}
-void* darray_push( void* darray, const void* item ) {
-    void* res = darray;
-    if( darray_try_push( res, item ) ) {
-        return res;
+        for( usize j = 0; res && j < darray_len( entry->includes ); ++j ) {
+            res = fd_write_fmt( &file, "inc %u\n", entry->includes[j] );
+        }
     }
 
-    res = darray_grow( res, 5 );
+    fd_close( &file );
     if( !res ) {
-        return NULL;
+        cb_error( "dep_index_save: failed to write '%s'!", index->path );
     }
-
-    darray_try_push( res, item );
     return res;
 }
-void* darray_emplace( void* darray, const void* item, usize at ) {
-    if( at >= darray_len( darray ) ) {
-        cb_warn(
-            "darray_emplace: attempted to emplace past darray bounds! "
-            "len: %zu index: %zu", darray_len( darray ), at );
-        return NULL;
+void dep_index_free( DepIndex* index ) {
+    if( index ) {
+        if( index->entries ) {
+            for( usize i = 0; i < darray_len( index->entries ); ++i ) {
+                dep_index_entry_free( index->entries + i );
+            }
+            darray_free( index->entries );
+        }
+        if( index->include_dirs ) {
+            for( usize i = 0; i < darray_len( index->include_dirs ); ++i ) {
+                dstring_free( index->include_dirs[i] );
+            }
+            darray_free( index->include_dirs );
+        }
+        if( index->path ) {
+            dstring_free( index->path );
+        }
+        memory_zero( index, sizeof(*index) );
     }
+}
 
-    void* res = darray;
-    if( darray_try_emplace( res, item, at ) ) {
-        return res;
+b32 compiler_cache_open( const char* dir, CompilerCache* out_cache ) {
+    assertion( dir && out_cache, "no directory or cache provided!" );
+    memory_zero( out_cache, sizeof(*out_cache) );
+
+    if( !path_exists( dir ) && !dir_create( dir ) ) {
+        cb_error(
+            "compiler_cache_open: failed to create directory '%s'!", dir );
+        return false;
     }
+    out_cache->dir = dstring_from_cstr( dir );
+    return out_cache->dir != NULL;
+}
+// per-platform: id of the current process, used to keep temp names
+// unique between concurrent builds sharing a cache directory.
+static u32 compiler_cache_writer_pid(void);
 
-    res = darray_grow( res, 5 );
-    if( !res ) {
-        return NULL;
+static b32 compiler_cache_key(
+    const Command* cmd, usize input_count, const char** inputs, u64* out_key
+) {
+    usize parts_size = sizeof(u64) * (input_count + 1);
+    u64*  parts      = memory_alloc( parts_size );
+    if( !parts ) {
+        return false;
     }
 
-    darray_try_emplace( res, item, at );
-    return res;
+    parts[0] = build_cache_hash_command( cmd );
+    if( input_count && !hash_file_batch( input_count, inputs, parts + 1 ) ) {
+        memory_free( parts, parts_size );
+        return false;
+    }
+
+    *out_key = hash_buffer( parts_size, parts );
+    memory_free( parts, parts_size );
+    return true;
 }
-void* darray_insert( void* darray, usize count, const void* items, usize at ) {
-    struct DynamicArray* res = darray_head( darray );
+b32 compiler_cache_exec(
+    CompilerCache* cache, const Command* cmd, const char* output,
+    usize input_count, const char** inputs, int* opt_out_res
+) {
+    assertion( cache && cache->dir, "cache is null!" );
+    assertion( cmd && output, "no command or output provided!" );
 
-    if( at >= res->len ) {
-        cb_warn(
-            "darray_insert: attempted to insert past darray bounds! "
-            "len: %zu index: %zu", res->len, at );
+    u64 key = 0;
+    if( !compiler_cache_key( cmd, input_count, inputs, &key ) ) {
+        return false;
+    }
+    DString* object =
+        dstring_fmt( "%s/%016llx.o", cache->dir, (unsigned long long)key );
+    if( !object ) {
         return false;
     }
 
-    if( darray_try_insert( res->buf, count, items, at ) ) {
-        return res->buf;
+    if( path_exists( object ) ) {
+        if( file_copy( output, object ) ) {
+            atomic_add( &cache->hits, 1 );
+            if( opt_out_res ) {
+                *opt_out_res = 0;
+            }
+            dstring_free( object );
+            return true;
+        }
+        // cached object could not be copied, recompile instead.
     }
+    atomic_add( &cache->misses, 1 );
 
-    res = darray_head( darray_grow( res->buf, (count - (res->cap - res->len)) + 5 ) );
-    if( !res ) {
-        return NULL;
+    PID pid = process_exec( *cmd, false, 0, 0, 0, 0 );
+    int res = process_wait( pid );
+    if( opt_out_res ) {
+        *opt_out_res = res;
+    }
+    if( res != 0 ) {
+        dstring_free( object );
+        return false;
     }
 
-    darray_try_insert( res->buf, count, items, at );
-    return res->buf;
+    // copy to a temp name and move into place so a concurrent build
+    // never observes a partially written object. The pid keeps two
+    // builds missing on the same key from sharing a temp file, the
+    // rename is the only point of contention.
+    DString* tmp = dstring_fmt(
+        "%s.%u.tmp", object, compiler_cache_writer_pid() );
+    if( tmp ) {
+        if( !file_copy( tmp, output ) || !file_move( object, tmp ) ) {
+            file_remove( tmp );
+        }
+        dstring_free( tmp );
+    }
+    dstring_free( object );
+    return true;
 }
-void* darray_append( void* darray, usize count, const void* items ) {
-    struct DynamicArray* res = darray_head( darray );
-    if( darray_try_append( res->buf, count, items ) ) {
-        return res;
+void compiler_cache_free( CompilerCache* cache ) {
+    if( cache ) {
+        if( cache->dir ) {
+            dstring_free( cache->dir );
+        }
+        memory_zero( cache, sizeof(*cache) );
     }
+}
 
-    res = darray_head( darray_grow( res->buf, (count - (res->cap - res->len)) + 5 ) );
-    if( !res ) {
-        return NULL;
-    }
+static void process_pool_proc( void* params ) {
+    ProcessPool* pool = (ProcessPool*)params;
+    for( ;; ) {
+        semaphore_wait( (Semaphore*)&pool->wakeup );
+        if( pool->shutdown ) {
+            atomic_add( &pool->stopped, 1 );
+            return;
+        }
 
-    darray_try_append( res->buf, count, items );
-    return res->buf;
-}
-b32 darray_remove( void* darray, usize index ) {
+        for( ;; ) {
+            // move queued entries into free slots.
+            mutex_lock( (Mutex*)&pool->lock );
+            while(
+                darray_len( pool->running ) < pool->max_parallel &&
+                darray_len( pool->queued )
+            ) {
+                ProcessPoolEntry entry = pool->queued[0];
+                expect( darray_remove( pool->queued, 0 ), "queue is empty!" );
+                mutex_unlock( (Mutex*)&pool->lock );
+
+                // exec outside lock so submitters are not held up by fork.
+                entry.pid = process_exec( entry.cmd, false, 0, 0, 0, 0 );
+                expect( darray_try_push( pool->running, &entry ),
+                    "miscalculated parallel slots!" );
+
+                mutex_lock( (Mutex*)&pool->lock );
+            }
+            mutex_unlock( (Mutex*)&pool->lock );
 
-    struct DynamicArray* head = darray_head( darray );
-    if( !head->len || index > head->len ) {
-        cb_warn(
-            "darray_remove: attempted to remove past array bounds! "
-            "len: %zu index: %zu", head->len, index );
-        return false;
-    }
-    if( index == (head->len - 1) ) {
-        return darray_pop( darray, 0 );
-    }
+            if( !darray_len( pool->running ) ) {
+                break;
+            }
 
-    void* item_to_remove = head->buf + (head->stride * index);
-    void* item_next      = (u8*)item_to_remove + head->stride;
-    usize move_size      = (head->buf + (head->stride * head->cap)) - (u8*)item_next;
+            // poll running commands, dispatch whichever completed.
+            for( usize i = 0; i < darray_len( pool->running ); ) {
+                ProcessPoolEntry* entry = pool->running + i;
 
-    memory_move( item_to_remove, item_next, move_size );
-    head->len--;
-    memory_zero( head->buf + (head->stride * head->len), head->stride );
+                int res = 0;
+                if( !process_wait_timed( entry->pid, &res, 1 ) ) {
+                    ++i;
+                    continue;
+                }
 
-    return true;
+                ProcessPoolEntry completed = *entry;
+                expect( darray_remove( pool->running, i ), "entry vanished!" );
+
+                if( completed.callback ) {
+                    completed.callback( &completed.cmd, res, completed.params );
+                }
+                atomic_add( &pool->pending, -1 );
+            }
+        }
+    }
 }
-b32 darray_remove_range( void* darray, usize from_inclusive, usize to_exclusive ) {
-    assertion( from_inclusive < to_exclusive,
-        "darray_remove_range: invalid range provided! (%zu, %zu]",
-        from_inclusive, to_exclusive );
-    struct DynamicArray* head = darray_head( darray );
-    if( !head->len || from_inclusive >= head->len || to_exclusive > head->len ) {
-        cb_warn(
-            "darray_remove_range: attempted to remove past array bounds! "
-            "len: %zu range: (%zu, %zu]", head->len, from_inclusive, to_exclusive );
+b32 process_pool_open( u32 max_parallel, ProcessPool* out_pool ) {
+    assertion( out_pool, "no pool provided!" );
+    assertion( max_parallel, "max_parallel must be >= 1!" );
+
+    memory_zero( out_pool, sizeof(*out_pool) );
+    out_pool->max_parallel = max_parallel;
+
+    out_pool->queued = darray_empty( sizeof(ProcessPoolEntry), 16 );
+    if( !out_pool->queued ) {
+        return false;
+    }
+    out_pool->running = darray_empty( sizeof(ProcessPoolEntry), max_parallel );
+    if( !out_pool->running ) {
+        darray_free( out_pool->queued );
         return false;
     }
-
-    // TODO(alicia): reimplement this properly
-    for( usize i = from_inclusive; i < to_exclusive; ++i ) {
-        darray_remove( darray, from_inclusive );
+    if( !mutex_create( &out_pool->lock ) ) {
+        darray_free( out_pool->running );
+        darray_free( out_pool->queued );
+        return false;
+    }
+    if( !semaphore_create( &out_pool->wakeup ) ) {
+        mutex_destroy( &out_pool->lock );
+        darray_free( out_pool->running );
+        darray_free( out_pool->queued );
+        return false;
     }
 
+    initialize_mt();
+    thread_create( process_pool_proc, out_pool );
     return true;
 }
-usize darray_remaining( const void* darray ) {
-    return darray_cap( darray ) - darray_len( darray );
-}
-usize darray_len( const void* darray ) {
-    return ((struct DynamicArray*)darray - 1)->len;
-}
-usize darray_cap( const void* darray ) {
-    return ((struct DynamicArray*)darray - 1)->cap;
-}
-usize darray_stride( const void* darray ) {
-    return ((struct DynamicArray*)darray - 1)->stride;
-}
-usize darray_total_size( const void* darray ) {
-    return
-        sizeof(struct DynamicArray) +
-        (darray_cap( darray ) * darray_stride( darray ));
-}
-b32 darray_is_empty( const void* darray ) {
-    return darray_len( darray ) == 0;
-}
-b32 darray_is_full( const void* darray ) {
-    return darray_len( darray ) == darray_cap( darray );
-}
-void* darray_head( void* darray ) {
-    if( !darray ) {
-        return NULL;
+b32 process_pool_submit(
+    ProcessPool* pool, Command cmd,
+    ProcessPoolFN* opt_callback, void* opt_params
+) {
+    assertion( pool && pool->queued, "pool is null!" );
+    assertion( cmd.count && cmd.args, "provided empty command!" );
+
+    ProcessPoolEntry entry;
+    memory_zero( &entry, sizeof(entry) );
+    entry.cmd      = cmd;
+    entry.callback = opt_callback;
+    entry.params   = opt_params;
+    entry.pid      = pid_null();
+
+    // increment before entry is visible so drain
+    // can never observe zero while entry is in flight.
+    atomic_add( &pool->pending, 1 );
+
+    mutex_lock( &pool->lock );
+    Darray(ProcessPoolEntry) _new = darray_push( pool->queued, &entry );
+    if( !_new ) {
+        mutex_unlock( &pool->lock );
+        atomic_add( &pool->pending, -1 );
+        return false;
     }
-    return (struct DynamicArray*)darray - 1;
+    pool->queued = _new;
+    mutex_unlock( &pool->lock );
+
+    semaphore_signal( &pool->wakeup );
+    return true;
 }
-const void* darray_head_const( const void* darray ) {
-    if( !darray ) {
-        return NULL;
+void process_pool_drain( ProcessPool* pool ) {
+    assertion( pool && pool->queued, "pool is null!" );
+    while( pool->pending ) {
+        thread_sleep(1);
     }
-    return (const struct DynamicArray*)darray - 1;
 }
-void darray_free( void* darray ) {
-    if( darray ) {
-        struct DynamicArray* head = darray_head( darray );
-        usize total_size = (head->cap * head->stride) + sizeof(*head);
-        memory_free( head, total_size );
+void process_pool_close( ProcessPool* pool ) {
+    if( !pool || !pool->queued ) {
+        return;
     }
-}
 
-b32 job_enqueue( JobFN* job, void* params ) {
-    volatile struct JobQueue* queue = get_job_queue();
+    process_pool_drain( pool );
 
-    if( queue->pending >= CBUILD_MAX_JOBS ) {
-        cb_warn(
-            "attempted to enqueue job while queue is full!" );
-        return false;
+    atomic_add( &pool->shutdown, 1 );
+    semaphore_signal( &pool->wakeup );
+    while( !pool->stopped ) {
+        thread_sleep(1);
     }
 
-    struct JobEntry entry;
-    entry.proc   = job;
-    entry.params = params;
+    semaphore_destroy( &pool->wakeup );
+    mutex_destroy( &pool->lock );
+    darray_free( pool->running );
+    darray_free( pool->queued );
+    memory_zero( pool, sizeof(*pool) );
+}
 
-    fence();
+struct RemoteManifestEntry {
+    DString* path;
+    u64      hash; // content hash of file when it was shipped
+};
+struct RemoteWorker {
+    DString* destination;
+    DString* workdir;
+    u32      max_parallel;
+    atom     running; // commands currently submitted to this worker
+    Mutex    lock;    // protects shipped manifest
+    Darray(struct RemoteManifestEntry) shipped;
+};
+static Darray(struct RemoteWorker) global_remote_workers = NULL;
+
+static struct RemoteWorker* remote_worker( usize worker ) {
+    assertion(
+        global_remote_workers && worker < darray_len( global_remote_workers ),
+        "invalid remote worker index!" );
+    return global_remote_workers + worker;
+}
+// append path to script wrapped in single quotes.
+static DString* remote_quote( DString* script, const char* path ) {
+    String str = string_from_cstr( path );
+    expect(
+        !string_find( str, '\'', 0 ),
+        "remote paths must not contain single quotes!" );
+    DString* res = dstring_push( script, '\'' );
+    if( res ) {
+        res = dstring_append( res, str );
+    }
+    if( res ) {
+        res = dstring_push( res, '\'' );
+    }
+    return res;
+}
+static b32 remote_run_script( const char* script ) {
+    const char* args[] = { "sh", "-c", script, NULL };
+    Command cmd;
+    cmd.count = 3;
+    cmd.args  = args;
 
-    atom back = atomic_add( &queue->back, 1 );
-    queue->entries[back % CBUILD_MAX_JOBS] = entry;
+    PID pid = process_exec( cmd, false, 0, 0, 0, 0 );
+    return process_wait( pid ) == 0;
+}
+b32 remote_worker_add(
+    const char* destination, const char* workdir, u32 max_parallel
+) {
+    assertion( destination && workdir, "no destination or workdir provided!" );
+    assertion( max_parallel, "max_parallel must be >= 1!" );
 
-    fence();
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_PROCESS );
 
-    atomic_add( &queue->len, 1 );
-    atomic_add( &queue->pending, 1 );
+    struct RemoteWorker worker;
+    memory_zero( &worker, sizeof(worker) );
+    worker.destination  = dstring_from_cstr( destination );
+    worker.workdir      = dstring_from_cstr( workdir );
+    worker.max_parallel = max_parallel;
+    worker.shipped      = darray_empty(
+        sizeof(struct RemoteManifestEntry), 16 );
 
-    semaphore_signal( (Semaphore*)&queue->wakeup );
-    return true;
-}
-b32 job_enqueue_timed( JobFN* job, void* params, u32 ms ) {
-    volatile struct JobQueue* queue = get_job_queue();
+    b32 res = false;
+    do {
+        if( !worker.destination || !worker.workdir || !worker.shipped ) {
+            break;
+        }
+        if( !mutex_create( &worker.lock ) ) {
+            break;
+        }
 
-    while( queue->pending >= CBUILD_MAX_JOBS ) {
-        if( !job_wait_next( ms ) ) {
-            return false;
+        if( !global_remote_workers ) {
+            global_remote_workers = darray_empty(
+                sizeof(struct RemoteWorker), 4 );
+            if( !global_remote_workers ) {
+                mutex_destroy( &worker.lock );
+                break;
+            }
         }
-    }
+        Darray(struct RemoteWorker) _new =
+            darray_push( global_remote_workers, &worker );
+        if( !_new ) {
+            mutex_destroy( &worker.lock );
+            break;
+        }
+        global_remote_workers = _new;
+        res = true;
+    } while( false );
 
-    expect( job_enqueue( job, params ),
-        "enqueue unexpectedly failed!" );
-    return true;
+    if( !res ) {
+        dstring_free( worker.destination );
+        dstring_free( worker.workdir );
+        darray_free( worker.shipped );
+    }
+    memory_tag_leave( tag );
+    return res;
 }
-b32 job_wait_next( u32 ms ) {
-    volatile struct JobQueue* queue = get_job_queue();
-
-    u32 current = queue->pending;
-    if( !current ) {
+usize remote_worker_count(void) {
+    return global_remote_workers ? darray_len( global_remote_workers ) : 0;
+}
+b32 remote_ship( usize worker_index, usize count, const char** paths ) {
+    struct RemoteWorker* worker = remote_worker( worker_index );
+    if( !count ) {
         return true;
     }
 
-    if( ms == MT_WAIT_INFINITE ) {
-        while( queue->pending >= current ) {
-            thread_sleep( 1 );
+    u64* hashes = memory_alloc( count * sizeof(u64) );
+    if( !hashes || !hash_file_batch( count, paths, hashes ) ) {
+        memory_free( hashes, count * sizeof(u64) );
+        return false;
+    }
+
+    // collect files the worker does not already have.
+    mutex_lock( &worker->lock );
+    DString* file_list = dstring_empty( 255 );
+    usize    changed   = 0;
+    b32      res       = file_list != NULL;
+    for( usize i = 0; res && i < count; ++i ) {
+        String path  = string_from_cstr( paths[i] );
+        usize  found = darray_len( worker->shipped );
+        for( usize j = 0; j < darray_len( worker->shipped ); ++j ) {
+            if( string_cmp(
+                string_from_dstring( worker->shipped[j].path ), path )
+            ) {
+                found = j;
+                break;
+            }
         }
-        return true;
-    } else for( u32 i = 0; i < ms; ++i ) {
-        if( queue->pending < current ) {
-            return true;
+        if(
+            found < darray_len( worker->shipped ) &&
+            worker->shipped[found].hash == hashes[i]
+        ) {
+            continue; // unchanged since last ship.
         }
-        thread_sleep( 1 );
-    }
 
-    return false;
-}
-b32 job_wait_all( u32 ms ) {
-    volatile struct JobQueue* queue = get_job_queue();
+        DString* appended = changed
+            ? dstring_push( file_list, ' ' ) : file_list;
+        if( appended ) {
+            appended = remote_quote( appended, paths[i] );
+        }
+        if( !appended ) {
+            res = false;
+            break;
+        }
+        file_list = appended;
+        changed++;
+    }
+
+    if( res && changed ) {
+        // one tar stream for everything that changed.
+        DString* script = dstring_fmt(
+            "tar -cf - %s | ssh %s 'mkdir -p %s && tar -xf - -C %s'",
+            file_list, worker->destination,
+            worker->workdir, worker->workdir );
+        res = script && remote_run_script( script );
+        dstring_free( script );
+    }
+
+    // everything in this batch is now current on the worker.
+    for( usize i = 0; res && i < count; ++i ) {
+        String path  = string_from_cstr( paths[i] );
+        usize  found = darray_len( worker->shipped );
+        for( usize j = 0; j < darray_len( worker->shipped ); ++j ) {
+            if( string_cmp(
+                string_from_dstring( worker->shipped[j].path ), path )
+            ) {
+                found = j;
+                break;
+            }
+        }
+        if( found < darray_len( worker->shipped ) ) {
+            worker->shipped[found].hash = hashes[i];
+            continue;
+        }
 
-    if( ms == MT_WAIT_INFINITE ) {
-        while( queue->pending ) {
-            thread_sleep(1);
+        struct RemoteManifestEntry entry;
+        memory_zero( &entry, sizeof(entry) );
+        entry.path = dstring_from_string( path );
+        entry.hash = hashes[i];
+        if( !entry.path ) {
+            res = false;
+            break;
         }
-        return true;
-    } else for( u32 i = 0; i < ms; ++i ) {
-        if( !queue->pending ) {
-            return true;
+        Darray(struct RemoteManifestEntry) _new =
+            darray_push( worker->shipped, &entry );
+        if( !_new ) {
+            dstring_free( entry.path );
+            res = false;
+            break;
         }
-        thread_sleep( 1 );
+        worker->shipped = _new;
     }
 
-    return false;
-}
-
-u32 thread_id(void) {
-    return global_thread_id;
+    mutex_unlock( &worker->lock );
+    dstring_free( file_list );
+    memory_free( hashes, count * sizeof(u64) );
+    return res;
 }
-b32 command_builder_new( const char* exe, CommandBuilder* out_builder ) {
-    out_builder->buf = darray_empty( sizeof(char), 128 );
-    if( !out_builder->buf ) {
-        return false;
+b32 remote_fetch( usize worker_index, usize count, const char** paths ) {
+    struct RemoteWorker* worker = remote_worker( worker_index );
+    if( !count ) {
+        return true;
     }
-    out_builder->args = darray_empty( sizeof(const char*), 5 );
-    if( !out_builder->args ) {
-        darray_free( out_builder->buf );
+
+    DString* file_list = dstring_empty( 255 );
+    if( !file_list ) {
         return false;
     }
-    command_builder_push( out_builder, exe );
-    return true;
-}
-void command_builder_clear( CommandBuilder* builder ) {
-    darray_clear( builder->buf );
-    darray_clear( builder->args );
-}
-b32 command_builder_push( CommandBuilder* builder, const char* arg ) {
-    usize arg_len = strlen( arg );
-    if( darray_remaining( builder->buf ) < arg_len + 1 ) {
-        Darray(char) new_buf = darray_grow( builder->buf, darray_cap( builder->buf ) );
-        if( !new_buf ) {
-            return false;
+    for( usize i = 0; i < count; ++i ) {
+        DString* appended = i ? dstring_push( file_list, ' ' ) : file_list;
+        if( appended ) {
+            appended = remote_quote( appended, paths[i] );
         }
-        builder->buf = new_buf;
-    }
-    if( darray_remaining( builder->args ) < 1 ) {
-        Darray(const char*) new_buf =
-            darray_grow( builder->args, darray_cap( builder->args ) );
-        if( !new_buf ) {
+        if( !appended ) {
+            dstring_free( file_list );
             return false;
         }
-        builder->args = new_buf;
+        file_list = appended;
     }
-    const char* new_arg = builder->buf + darray_len( builder->buf );
-    darray_try_append( builder->buf, arg_len + 1, arg );
 
-    darray_pop( builder->args, 0 );
-    darray_try_push( builder->args, &new_arg );
-    const char* null = 0;
-    darray_try_push( builder->args, &null );
+    DString* script = dstring_fmt(
+        "ssh %s 'cd %s && tar -cf - %s' | tar -xf -",
+        worker->destination, worker->workdir, file_list );
+    dstring_free( file_list );
+    if( !script ) {
+        return false;
+    }
 
-    return true;
+    b32 res = remote_run_script( script );
+    dstring_free( script );
+    return res;
 }
-b32 __internal_command_builder_append(
-    CommandBuilder* builder, const char* first, ...
+// build "cd '<workdir>' && <flattened cmd>" for running through ssh.
+static DString* remote_command_script(
+    const struct RemoteWorker* worker, Command cmd
 ) {
-    if( !command_builder_push( builder, first ) ) {
-        return false;
+    DString* flat = command_flatten_dstring( &cmd );
+    if( !flat ) {
+        return NULL;
+    }
+    DString* script = dstring_fmt(
+        "cd '%s' && %s", worker->workdir, flat );
+    dstring_free( flat );
+    return script;
+}
+PID remote_exec( usize worker_index, Command cmd ) {
+    struct RemoteWorker* worker = remote_worker( worker_index );
+
+    DString* script = remote_command_script( worker, cmd );
+    expect( script, "failed to build remote command!" );
+
+    const char* args[] = { "ssh", worker->destination, script, NULL };
+    Command remote_cmd;
+    remote_cmd.count = 3;
+    remote_cmd.args  = args;
+
+    // fork copies the script before this frame unwinds.
+    PID pid = process_exec( remote_cmd, false, 0, 0, 0, 0 );
+    dstring_free( script );
+    return pid;
+}
+struct RemotePoolSubmit {
+    Command        original;
+    usize          worker;
+    ProcessPoolFN* callback;
+    void*          params;
+    DString*       script;
+    const char*    args[4];
+};
+static void process_pool_remote_callback(
+    const Command* cmd, int res, void* params
+) {
+    unused( cmd );
+    struct RemotePoolSubmit* submit = params;
+    atomic_add( &remote_worker( submit->worker )->running, -1 );
+    if( submit->callback ) {
+        submit->callback( &submit->original, res, submit->params );
+    }
+    dstring_free( submit->script );
+    memory_free( submit, sizeof(*submit) );
+}
+b32 process_pool_submit_remote(
+    ProcessPool* pool, Command cmd, usize input_count, const char** inputs,
+    ProcessPoolFN* opt_callback, void* opt_params
+) {
+    if( !remote_worker_count() ) {
+        return process_pool_submit( pool, cmd, opt_callback, opt_params );
     }
-    va_list va;
-    va_start( va, first );
 
-    for( ;; ) {
-        const char* next = va_arg( va, const char* );
-        if( !next ) {
-            break;
+    // least loaded worker relative to its parallelism.
+    usize best = 0;
+    for( usize i = 1; i < remote_worker_count(); ++i ) {
+        struct RemoteWorker* candidate = remote_worker( i );
+        struct RemoteWorker* current   = remote_worker( best );
+        if(
+            (u64)candidate->running * current->max_parallel <
+            (u64)current->running * candidate->max_parallel
+        ) {
+            best = i;
         }
+    }
+    struct RemoteWorker* worker = remote_worker( best );
 
-        if( !command_builder_push( builder, next ) ) {
-            va_end(va);
-            return false;
-        }
+    if( !remote_ship( best, input_count, inputs ) ) {
+        return false;
     }
 
-    va_end(va);
+    MemoryTag tag = memory_tag_enter( MEMORY_TAG_PROCESS );
+    struct RemotePoolSubmit* submit = memory_alloc( sizeof(*submit) );
+    memory_tag_leave( tag );
+    if( !submit ) {
+        return false;
+    }
+    submit->original = cmd;
+    submit->worker   = best;
+    submit->callback = opt_callback;
+    submit->params   = opt_params;
+    submit->script   = remote_command_script( worker, cmd );
+    if( !submit->script ) {
+        memory_free( submit, sizeof(*submit) );
+        return false;
+    }
+    submit->args[0] = "ssh";
+    submit->args[1] = worker->destination;
+    submit->args[2] = submit->script;
+    submit->args[3] = NULL;
+
+    Command remote_cmd;
+    remote_cmd.count = 3;
+    remote_cmd.args  = submit->args;
+
+    atomic_add( &worker->running, 1 );
+    if( !process_pool_submit(
+        pool, remote_cmd, process_pool_remote_callback, submit )
+    ) {
+        atomic_add( &worker->running, -1 );
+        dstring_free( submit->script );
+        memory_free( submit, sizeof(*submit) );
+        return false;
+    }
     return true;
 }
-b32 command_builder_append_list(
-    CommandBuilder* builder, usize count, const char** args
+
+// NOTE(alicia): capture thread is platform-specific,
+// poll() on POSIX, PeekNamedPipe() on Windows.
+static void pipe_capture_proc( void* params );
+// NOTE(alicia): caller must hold capture lock.
+static void pipe_capture_collect(
+    PipeCapture* capture, Darray(PipeCaptureEntry)* active
 ) {
-    for( usize i = 0; i < count; ++i ) {
-        if( !command_builder_push( builder, args[i])) {
-            return false;
-        }
+    for( usize i = 0; i < darray_len( capture->submitted ); ++i ) {
+        Darray(PipeCaptureEntry) _new =
+            darray_push( *active, capture->submitted + i );
+        expect( _new, "failed to track captured pipe!" );
+        *active = _new;
     }
-    return true;
-}
-Command command_builder_cmd( CommandBuilder* builder ) {
-    return (Command){
-        .count = darray_len(builder->args) - 1,
-        .args  = builder->args,
-    };
+    darray_clear( capture->submitted );
 }
-void command_builder_free( CommandBuilder* builder ) {
-    darray_free( builder->buf );
-    darray_free( builder->args );
-    memory_zero( builder, sizeof(*builder) );
+static void pipe_capture_finish(
+    PipeCapture* capture, Darray(PipeCaptureEntry) active, usize index
+) {
+    PipeCaptureEntry* entry = active + index;
+    if( entry->callback ) {
+        entry->callback( string_from_dstring( entry->buf ), entry->params );
+    }
+    pipe_close( entry->pipe );
+    dstring_free( entry->buf );
+    darray_remove( active, index );
+    atomic_add( &capture->pending, -1 );
 }
-DString* command_flatten_dstring( const Command* command ) {
-    usize total_len = 1;
-    for( usize i = 0; i < command->count; ++i ) {
-        total_len += strlen( command->args[i] ) + 3; // to account for potential "" and space
+b32 pipe_capture_open( PipeCapture* out_capture ) {
+    assertion( out_capture, "no capture engine provided!" );
+    memory_zero( out_capture, sizeof(*out_capture) );
+
+    out_capture->submitted = darray_empty( sizeof(PipeCaptureEntry), 8 );
+    if( !out_capture->submitted ) {
+        return false;
     }
-    DString* res = dstring_empty( total_len );
-    if( !res ) {
-        return NULL;
+    if( !mutex_create( &out_capture->lock ) ) {
+        darray_free( out_capture->submitted );
+        return false;
     }
+    pipe_open( &out_capture->wake_read, &out_capture->wake_write );
 
-    for( usize i = 0; i < command->count; ++i ) {
-        const char* current = command->args[i];
-        if( !current ) {
-            continue;
-        }
+    initialize_mt();
+    thread_create( pipe_capture_proc, out_capture );
+    return true;
+}
+b32 pipe_capture_submit(
+    PipeCapture* capture, ReadPipe pipe,
+    PipeCaptureFN* callback, void* opt_params
+) {
+    assertion( capture && capture->submitted, "capture engine is null!" );
+
+    PipeCaptureEntry entry;
+    memory_zero( &entry, sizeof(entry) );
+    entry.pipe     = pipe;
+    entry.callback = callback;
+    entry.params   = opt_params;
+    entry.buf      = dstring_empty( 255 );
+    if( !entry.buf ) {
+        return false;
+    }
 
-        usize current_len = strlen( current );
-        if( !current_len ) {
-            continue;
-        }
+    // increment before entry is visible so drain
+    // can never observe zero while entry is in flight.
+    atomic_add( &capture->pending, 1 );
 
-        b32 contains_space = false;
-        String arg = string_new( current_len, current );
-        if( string_find( arg, ' ', 0 ) ) {
-            expect( dstring_push( res, '"' ) == res, "miscalculated total_len!" );
-            contains_space = true;
-        }
+    mutex_lock( &capture->lock );
+    Darray(PipeCaptureEntry) _new = darray_push( capture->submitted, &entry );
+    if( !_new ) {
+        mutex_unlock( &capture->lock );
+        atomic_add( &capture->pending, -1 );
+        dstring_free( entry.buf );
+        return false;
+    }
+    capture->submitted = _new;
+    mutex_unlock( &capture->lock );
 
-        expect( dstring_append( res, arg ) == res, "miscalculated total_len!" );
+    fd_write( &capture->wake_write, 1, "", 0 );
+    return true;
+}
+void pipe_capture_drain( PipeCapture* capture ) {
+    assertion( capture && capture->submitted, "capture engine is null!" );
+    while( capture->pending ) {
+        thread_sleep(1);
+    }
+}
+void pipe_capture_close( PipeCapture* capture ) {
+    if( !capture || !capture->submitted ) {
+        return;
+    }
 
-        if( contains_space ) {
-            expect( dstring_push( res, '"' ) == res, "miscalculated total_len!" );
-        }
+    pipe_capture_drain( capture );
 
-        if( i + 1 != command->count ) {
-            expect( dstring_push( res, ' ' ) == res, "miscalculated total_len!" );
-        }
+    atomic_add( &capture->shutdown, 1 );
+    fd_write( &capture->wake_write, 1, "", 0 );
+    while( !capture->stopped ) {
+        thread_sleep(1);
     }
 
-    return res;
+    pipe_close( capture->wake_read );
+    pipe_close( capture->wake_write );
+    mutex_destroy( &capture->lock );
+    darray_free( capture->submitted );
+    memory_zero( capture, sizeof(*capture) );
 }
 
 u8* local_byte_buffer() {
-    fence();
-    return (u8*)get_next_local_buffer( thread_id() );
+    return scratch_alloc( CBUILD_LOCAL_BUFFER_CAPACITY );
 }
 char* local_fmt_va( const char* format, va_list va ) {
     char* buf = (char*)local_byte_buffer();
-    vsnprintf( buf, CBUILD_LOCAL_BUFFER_CAPACITY - 1, format, va ); // -1 to ensure null-terminated
+
+    struct FmtDst dst;
+    memory_zero( &dst, sizeof(dst) );
+    dst.buf = buf;
+    dst.cap = CBUILD_LOCAL_BUFFER_CAPACITY - 1; // -1 to ensure null-terminated
+
+    fmt_core_va( &dst, format, va );
+    buf[dst.len] = 0;
     return buf;
 }
 char* local_fmt( const char* format, ... ) {
@@ -3890,12 +10002,100 @@ static b32 logger_check_level( LoggerLevel level ) {
     return level >= global_logger_level;
 }
 
+static struct LoggerStage* logger_get_stage(void) {
+    struct LoggerStage* stage = global_logger_stage;
+    if( stage ) {
+        return stage;
+    }
+
+    stage = memory_alloc( sizeof(*stage) );
+    expect( stage, "failed to allocate logger staging buffer!" );
+    expect( mutex_create( &stage->lock ),
+        "failed to create logger staging mutex!" );
+
+    if( global_is_mt ) {
+        mutex_lock( &global_logger_mutex );
+    }
+    stage->next = (struct LoggerStage*)global_logger_stage_list;
+    global_logger_stage_list = stage;
+    if( global_is_mt ) {
+        mutex_unlock( &global_logger_mutex );
+    }
+
+    global_logger_stage = stage;
+    return stage;
+}
+// NOTE(alicia): implemented per-platform, stdout/stderr descriptor.
+static FD* logger_level_fd( LoggerLevel level );
+
+// NOTE(alicia): caller must hold stage lock.
+static void logger_stage_write( struct LoggerStage* stage ) {
+    if( stage->len ) {
+        // single write keeps staged lines whole.
+        fd_write(
+            logger_level_fd( LOGGER_LEVEL_INFO ),
+            stage->len, stage->buf, 0 );
+        stage->len = 0;
+    }
+}
+static void logger_stage_append( const char* line, usize len ) {
+    struct LoggerStage* stage = logger_get_stage();
+
+    mutex_lock( &stage->lock );
+    if( stage->len + len > CBUILD_LOGGER_STAGE_CAPACITY ) {
+        logger_stage_write( stage );
+    }
+    memory_copy( stage->buf + stage->len, line, len );
+    stage->len += len;
+    mutex_unlock( &stage->lock );
+}
+static void logger_writer_proc( void* params ) {
+    unused(params);
+    for( ;; ) {
+        thread_sleep( 100 );
+        if( global_logger_async ) {
+            logger_flush();
+        }
+    }
+}
+
 void logger_set_level( LoggerLevel level ) {
     global_logger_level = level;
 }
 LoggerLevel logger_get_level(void) {
     return global_logger_level;
 }
+void logger_set_async( b32 async ) {
+    if( async ) {
+        if( global_logger_async ) {
+            return;
+        }
+        initialize_mt();
+        if( !global_logger_writer_live ) {
+            atomic_add( &global_logger_writer_live, 1 );
+            thread_create( logger_writer_proc, NULL );
+        }
+        atomic_add( &global_logger_async, 1 );
+    } else if( global_logger_async ) {
+        atomic_add( &global_logger_async, -1 );
+        logger_flush();
+    }
+}
+void logger_flush(void) {
+    if( global_is_mt ) {
+        mutex_lock( &global_logger_mutex );
+    }
+    struct LoggerStage* stage = (struct LoggerStage*)global_logger_stage_list;
+    if( global_is_mt ) {
+        mutex_unlock( &global_logger_mutex );
+    }
+
+    for( ; stage; stage = stage->next ) {
+        mutex_lock( &stage->lock );
+        logger_stage_write( stage );
+        mutex_unlock( &stage->lock );
+    }
+}
 void logger_va( LoggerLevel level, const char* format, va_list va ) {
     if( !logger_check_level( level ) ) {
         return;
@@ -3915,25 +10115,44 @@ void logger_va( LoggerLevel level, const char* format, va_list va ) {
         "\033[1;35m", // LOGGER_LEVEL_FATAL
     };
 
-    FILE* const level_output[] = {
-        stdout, // LOGGER_LEVEL_INFO
-        stdout, // LOGGER_LEVEL_WARNING
-        stderr, // LOGGER_LEVEL_ERROR
-        stderr, // LOGGER_LEVEL_FATAL
-    };
+    if( global_logger_async ) {
+        if( level < LOGGER_LEVEL_ERROR ) {
+            char  line[CBUILD_LOGGER_STAGE_CAPACITY];
+            usize len = snprintf(
+                line, sizeof(line), "%s[%c:%02u] cbuild: ",
+                local_level_colors[level],
+                local_level_letters[level], thread_id() );
+            len += vsnprintf( line + len, sizeof(line) - len, format, va );
+            if( len > sizeof(line) - (sizeof("\033[1;00m\n") + 1) ) {
+                len = sizeof(line) - (sizeof("\033[1;00m\n") + 1);
+            }
+            len += snprintf( line + len, sizeof(line) - len, "\033[1;00m\n" );
+
+            logger_stage_append( line, len );
+            return;
+        }
+        // write-through messages should not
+        // overtake messages staged before them.
+        logger_flush();
+    }
 
     if( global_is_mt ) {
         mutex_lock( &global_logger_mutex );
     }
 
-    FILE* output = level_output[level];
-
-    fprintf( output, "%s[%c:%02u] cbuild: ",
+    char  prefix[64];
+    usize prefix_len = snprintf(
+        prefix, sizeof(prefix), "%s[%c:%02u] cbuild: ",
         local_level_colors[level], local_level_letters[level], thread_id() );
-    vfprintf( output, format, va );
-    fprintf( output, "\033[1;00m\n" );
 
-    fflush( output );
+    char* body = local_fmt_va( format, va );
+
+    // single vectored write keeps the line whole.
+    String parts[3];
+    parts[0] = string_new( prefix_len, prefix );
+    parts[1] = string_from_cstr( body );
+    parts[2] = string_text( "\033[1;00m\n" );
+    fd_write_many( logger_level_fd( level ), 3, parts );
 
     if( global_is_mt ) {
         mutex_unlock( &global_logger_mutex );
@@ -3963,13 +10182,53 @@ struct Win32ThreadParams {
 
 #define CBUILD_LOCAL_WIDE_CAPACITY (CBUILD_LOCAL_BUFFER_CAPACITY / 2)
 
-static struct Win32ThreadParams global_win32_thread_params[CBUILD_THREAD_COUNT];
+static struct Win32ThreadParams global_win32_thread_params[CBUILD_THREAD_COUNT + CBUILD_SERVICE_THREAD_COUNT];
 
 static HANDLE global_win32_process_heap = NULL;
 
+// NOTE(alicia): WaitOnAddress lives in an api set that not every
+// toolchain links by default so it's loaded manually instead.
+typedef BOOL WaitOnAddressFN( volatile VOID*, PVOID, SIZE_T, DWORD );
+typedef VOID WakeByAddressFN( PVOID );
+
+static WaitOnAddressFN* global_win32_wait_on_address     = NULL;
+static WakeByAddressFN* global_win32_wake_by_address_one = NULL;
+static WakeByAddressFN* global_win32_wake_by_address_all = NULL;
+
 void _platform_init_(void) {
     SetConsoleCP( CP_UTF8 );
     SetConsoleOutputCP( CP_UTF8 );
+
+    HMODULE synch = LoadLibraryA( "api-ms-win-core-synch-l1-2-0.dll" );
+    if( synch ) {
+        global_win32_wait_on_address =
+            (WaitOnAddressFN*)GetProcAddress( synch, "WaitOnAddress" );
+        global_win32_wake_by_address_one =
+            (WakeByAddressFN*)GetProcAddress( synch, "WakeByAddressSingle" );
+        global_win32_wake_by_address_all =
+            (WakeByAddressFN*)GetProcAddress( synch, "WakeByAddressAll" );
+    }
+}
+static void futex_wait( atom* address, atom expected, u32 ms ) {
+    if( global_win32_wait_on_address ) {
+        global_win32_wait_on_address(
+            (volatile VOID*)address, (PVOID)&expected, sizeof(*address),
+            ms == MT_WAIT_INFINITE ? INFINITE : ms );
+        return;
+    }
+    // pre windows 8, poll instead.
+    if( *address == expected ) {
+        Sleep( 1 );
+    }
+}
+static void futex_wake( atom* address, b32 all ) {
+    if( all ) {
+        if( global_win32_wake_by_address_all ) {
+            global_win32_wake_by_address_all( (PVOID)address );
+        }
+    } else if( global_win32_wake_by_address_one ) {
+        global_win32_wake_by_address_one( (PVOID)address );
+    }
 }
 static HANDLE get_process_heap(void) {
     if( !global_win32_process_heap ) {
@@ -4225,13 +10484,7 @@ void* memory_alloc( usize size ) {
     if( !res ) {
         return NULL;
     }
-    if( global_is_mt ) {
-        atomic_add64( &global_memory_usage, size );
-        atomic_add64( &global_total_memory_usage, size );
-    } else {
-        global_memory_usage       += size;
-        global_total_memory_usage += size;
-    }
+    memory_track_alloc( size );
     return res;
 }
 void* memory_realloc( void* memory, usize old_size, usize new_size ) {
@@ -4240,14 +10493,7 @@ void* memory_realloc( void* memory, usize old_size, usize new_size ) {
     if( !res ) {
         return NULL;
     }
-    usize diff = new_size - old_size;
-    if( global_is_mt ) {
-        atomic_add64( &global_memory_usage, diff );
-        atomic_add64( &global_total_memory_usage, diff );
-    } else {
-        global_memory_usage       += diff;
-        global_total_memory_usage += diff;
-    }
+    memory_track_alloc( new_size - old_size );
     return res;
 }
 void memory_free( void* memory, usize size ) {
@@ -4256,13 +10502,7 @@ void memory_free( void* memory, usize size ) {
         return;
     }
     HeapFree( get_process_heap(), 0, memory );
-    atom64 neg = size;
-    neg = -neg;
-    if( global_is_mt ) {
-        atomic_add64( &global_memory_usage, neg );
-    } else {
-        global_memory_usage += neg;
-    }
+    memory_track_free( size );
 }
 b32 path_is_absolute( const char* path ) {
     assertion( path, "null path!" );
@@ -4387,6 +10627,80 @@ static b32 path_walk_dir_internal(
     return path_walk_dir_internal_long(
         path, recursive, include_dirs, out_count, out_buffer );
 }
+static b32 path_walk_dir_shallow(
+    DString* dir, b32 include_dirs,
+    usize* out_count, DString** out_buffer, Darray(DString*)* out_subdirs
+) {
+    DString* pattern =
+        dstring_concat( string_from_dstring( dir ), string_text( "/*" ) );
+    if( !pattern ) {
+        return false;
+    }
+    wchar_t* wpath = win32_local_path_canon( string_from_dstring( pattern ) );
+    dstring_free( pattern );
+
+    WIN32_FIND_DATAW fd;
+    memory_zero( &fd, sizeof(fd) );
+    HANDLE find_file = FindFirstFileW( wpath, &fd );
+    if( find_file == INVALID_HANDLE_VALUE ) {
+        return false;
+    }
+
+    do {
+        if(
+            wcscmp( fd.cFileName, L"." )    == 0 ||
+            wcscmp( fd.cFileName, L".." )   == 0 ||
+            wcscmp( fd.cFileName, L".git" ) == 0
+        ) {
+            continue;
+        }
+
+        usize  name_len = wcslen( fd.cFileName );
+        String npath    = win32_local_wide_to_utf8( name_len, fd.cFileName );
+
+        DString* full = dstring_fmt( "%s/%.*s", dir, (int)npath.len, npath.cc );
+        if( !full ) {
+            FindClose( find_file );
+            return false;
+        }
+
+        if( fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) {
+            if( include_dirs ) {
+                DString* _new = dstring_append(
+                    *out_buffer, string_new( dstring_len( full ) + 1, full ) );
+                if( !_new ) {
+                    dstring_free( full );
+                    FindClose( find_file );
+                    return false;
+                }
+                *out_buffer = _new;
+                *out_count += 1;
+            }
+
+            Darray(DString*) _subs = darray_push( *out_subdirs, &full );
+            if( !_subs ) {
+                dstring_free( full );
+                FindClose( find_file );
+                return false;
+            }
+            *out_subdirs = _subs;
+            continue;
+        }
+
+        DString* _new = dstring_append(
+            *out_buffer, string_new( dstring_len( full ) + 1, full ) );
+        dstring_free( full );
+        if( !_new ) {
+            FindClose( find_file );
+            return false;
+        }
+        *out_buffer = _new;
+        *out_count += 1;
+    } while( FindNextFileW( find_file, &fd ) != FALSE );
+
+    FindClose( find_file );
+    return true;
+}
 
 static DWORD fd_open_dwaccess( FileOpenFlags flags ) {
     DWORD res = 0;
@@ -4554,6 +10868,47 @@ b32 fd_write( FD* file, usize size, const void* buf, usize* opt_out_write_size )
     return fd_write_32( file, size, buf, (DWORD*)opt_out_write_size );
 #endif
 }
+b32 fd_write_many( FD* file, usize count, const String* parts ) {
+    // NOTE(alicia): WriteFileGather requires page-aligned buffers so
+    // parts are coalesced into one buffered write per chunk instead.
+    char* buf  = (char*)local_byte_buffer();
+    usize used = 0;
+    for( usize i = 0; i < count; ++i ) {
+        String part = parts[i];
+        if( part.len >= CBUILD_LOCAL_BUFFER_CAPACITY ) {
+            if( used ) {
+                if( !fd_write( file, used, buf, 0 ) ) {
+                    return false;
+                }
+                used = 0;
+            }
+            if( !fd_write( file, part.len, part.cc, 0 ) ) {
+                return false;
+            }
+            continue;
+        }
+        if( used + part.len > CBUILD_LOCAL_BUFFER_CAPACITY ) {
+            if( !fd_write( file, used, buf, 0 ) ) {
+                return false;
+            }
+            used = 0;
+        }
+        memory_copy( buf + used, part.cc, part.len );
+        used += part.len;
+    }
+    if( used ) {
+        return fd_write( file, used, buf, 0 );
+    }
+    return true;
+}
+static FD* logger_level_fd( LoggerLevel level ) {
+    static FD fds[2] = { 0, 0 };
+    if( !fds[0] ) {
+        fds[0] = (FD)GetStdHandle( STD_OUTPUT_HANDLE );
+        fds[1] = (FD)GetStdHandle( STD_ERROR_HANDLE );
+    }
+    return fds + (level >= LOGGER_LEVEL_ERROR);
+}
 b32 fd_read( FD* file, usize size, void* buf, usize* opt_out_read_size ) {
 #if defined(ARCH_64BIT)
     return fd_read_64( file, size, buf, opt_out_read_size );
@@ -4617,6 +10972,55 @@ usize fd_query_position( FD* file ) {
     return res;
 #endif
 
+}
+b32 fd_map( FD* file, FileMap* out_map ) {
+    assertion( file, "no file provided!" );
+    assertion( out_map, "no map provided!" );
+
+    memory_zero( out_map, sizeof(*out_map) );
+
+    usize size = fd_query_size( file );
+    if( !size ) {
+        // mapping a zero-length file is invalid,
+        // an empty view needs no mapping anyway.
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(
+        (HANDLE)*file, NULL, PAGE_READONLY, 0, 0, NULL );
+    if( !mapping ) {
+        return false;
+    }
+
+    void* view = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    if( !view ) {
+        CloseHandle( mapping );
+        return false;
+    }
+
+    out_map->view   = string_new( size, (const char*)view );
+    out_map->handle = (void*)mapping;
+    return true;
+}
+b32 file_map( const char* path, FileMap* out_map ) {
+    FD file;
+    if( !fd_open( path, FOPEN_READ, &file ) ) {
+        return false;
+    }
+    b32 res = fd_map( &file, out_map );
+    fd_close( &file );
+    return res;
+}
+void file_unmap( FileMap* map ) {
+    if( map ) {
+        if( map->view.cc && map->view.len ) {
+            UnmapViewOfFile( (LPCVOID)map->view.cc );
+        }
+        if( map->handle ) {
+            CloseHandle( (HANDLE)map->handle );
+        }
+        memory_zero( map, sizeof(*map) );
+    }
 }
 static void file_query_time_long(
     String path, FILETIME* out_create, FILETIME* out_modify
@@ -4657,6 +11061,33 @@ time_t file_query_time_modify( const char* path ) {
     file_query_time_long( string_new( path_len, path ), 0, &modify );
     return win32_filetime_to_posix( modify );
 }
+b32 file_stat( const char* path, FileStat* out_stat ) {
+    assertion( path && out_stat, "no path or out pointer provided!" );
+    memory_zero( out_stat, sizeof(*out_stat) );
+
+    usize path_len = strlen( path );
+    wchar_t* wpath = win32_local_path_canon( string_new( path_len, path ) );
+
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    memory_zero( &data, sizeof(data) );
+    if( !GetFileAttributesExW( wpath, GetFileExInfoStandard, &data ) ) {
+        return false;
+    }
+
+    out_stat->exists      = true;
+    out_stat->time_modify = win32_filetime_to_posix( data.ftLastWriteTime );
+    out_stat->size        = (usize)(
+        ((u64)data.nFileSizeHigh << 32) | (u64)data.nFileSizeLow );
+    return true;
+}
+static void file_stat_many( usize count, const char** paths, FileStat* out_stats ) {
+    // NOTE(alicia): GetFileAttributesExW reads straight from the
+    // directory metadata without opening a handle, so there is no
+    // per-directory handle to cache here.
+    for( usize i = 0; i < count; ++i ) {
+        file_stat( paths[i], out_stats + i );
+    }
+}
 
 static b32 file_move_long( String dst, String src ) {
     wchar_t* dst_wide = win32_local_path_canon( dst );
@@ -4830,14 +11261,173 @@ void pipe_close( Pipe pipe ) {
     HANDLE handle = (HANDLE)pipe;
     CloseHandle( handle );
 }
-b32 process_in_path( const char* process_name ) {
-    char* cmd = local_fmt( "where.exe %s /Q", process_name );
-    return system( cmd ) == 0;
+static void pipe_capture_discard_pipe( HANDLE pipe ) {
+    DWORD avail = 0;
+    while( PeekNamedPipe( pipe, 0, 0, 0, &avail, 0 ) && avail ) {
+        char  discard[64];
+        DWORD read_size = 0;
+        if( !ReadFile( pipe, discard, sizeof(discard), &read_size, 0 ) ) {
+            break;
+        }
+    }
+}
+static void pipe_capture_proc( void* params ) {
+    PipeCapture* capture = params;
+
+    Darray(PipeCaptureEntry) active =
+        darray_empty( sizeof(PipeCaptureEntry), 8 );
+    expect( active, "failed to allocate pipe capture state!" );
+
+    for( ;; ) {
+        mutex_lock( &capture->lock );
+        pipe_capture_collect( capture, &active );
+        mutex_unlock( &capture->lock );
+
+        if( capture->shutdown && !darray_len( active ) ) {
+            break;
+        }
+
+        // wake bytes are only used to interrupt poll() on POSIX,
+        // drain them so the wake pipe can't fill up.
+        pipe_capture_discard_pipe( (HANDLE)capture->wake_read );
+
+        b32 progressed = false;
+        for( usize i = darray_len( active ); i-- > 0; ) {
+            PipeCaptureEntry* entry = active + i;
+
+            DWORD avail = 0;
+            if( PeekNamedPipe(
+                (HANDLE)entry->pipe, 0, 0, 0, &avail, 0 )
+            ) {
+                if( !avail ) {
+                    continue;
+                }
+                char* chunk = (char*)local_byte_buffer();
+                DWORD read_size = 0;
+                if( ReadFile(
+                    (HANDLE)entry->pipe, chunk,
+                    CBUILD_LOCAL_BUFFER_CAPACITY, &read_size, 0 ) && read_size
+                ) {
+                    DString* _new = dstring_append(
+                        entry->buf, string_new( read_size, chunk ) );
+                    expect( _new, "failed to append captured output!" );
+                    entry->buf = _new;
+                    progressed = true;
+                    continue;
+                }
+            }
+            // write end closed, pipe is done.
+            pipe_capture_finish( capture, active, i );
+            progressed = true;
+        }
+
+        if( !progressed ) {
+            thread_sleep( 1 );
+        }
+    }
+
+    darray_free( active );
+    atomic_add( &capture->stopped, 1 );
+}
+b32 path_watch(
+    const char* dir, const WalkDirectory* wd,
+    WatchFN* callback, void* opt_params
+) {
+    assertion( dir && callback, "no directory or callback provided!" );
+    unused( wd ); // subtree watch covers subdirectories.
+
+    wchar_t* wide   = win32_local_path_canon( string_from_cstr( dir ) );
+    HANDLE   handle = CreateFileW(
+        wide, FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL );
+    if( handle == INVALID_HANDLE_VALUE ) {
+        cb_error( "path_watch: failed to open directory '%s'!", dir );
+        return false;
+    }
+
+    for( ;; ) {
+        DWORD size = 0;
+        u64   raw[1024]; // aligned for FILE_NOTIFY_INFORMATION.
+        if( !ReadDirectoryChangesW(
+            handle, raw, sizeof(raw), TRUE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+            FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+            &size, NULL, NULL )
+        ) {
+            cb_error( "path_watch: failed to read changes in '%s'!", dir );
+            CloseHandle( handle );
+            return false;
+        }
+
+        ScratchScope scope = scratch_begin();
+        Darray(String) changed = darray_empty( sizeof(String), 8 );
+        expect( changed, "failed to allocate changed list!" );
+
+        char* at = (char*)raw;
+        for( ;; ) {
+            FILE_NOTIFY_INFORMATION* info = (FILE_NOTIFY_INFORMATION*)at;
+
+            char* utf8 = (char*)local_byte_buffer();
+            int   len  = WideCharToMultiByte(
+                CP_UTF8, 0, info->FileName,
+                info->FileNameLength / sizeof(wchar_t),
+                utf8, CBUILD_LOCAL_BUFFER_CAPACITY - 1, 0, 0 );
+            for( int i = 0; i < len; ++i ) {
+                if( utf8[i] == '\\' ) {
+                    utf8[i] = '/';
+                }
+            }
+            // full path lives in this iteration's scratch scope.
+            String full = string_from_cstr(
+                local_fmt( "%s/%.*s", dir, len, utf8 ) );
+
+            b32 seen = false;
+            for( usize i = 0; i < darray_len( changed ); ++i ) {
+                if( string_cmp( changed[i], full ) ) {
+                    seen = true;
+                    break;
+                }
+            }
+            if( !seen ) {
+                Darray(String) _new = darray_push( changed, &full );
+                expect( _new, "failed to grow changed list!" );
+                changed = _new;
+            }
+
+            if( !info->NextEntryOffset ) {
+                break;
+            }
+            at += info->NextEntryOffset;
+        }
+
+        b32 keep = true;
+        if( darray_len( changed ) ) {
+            keep = callback( changed, opt_params );
+        }
+        darray_free( changed );
+        scratch_end( scope );
+
+        if( !keep ) {
+            break;
+        }
+    }
+
+    CloseHandle( handle );
+    return true;
+}
+static b32 process_resolve_executable( const char* path ) {
+    return path_exists( path );
+}
+static u32 compiler_cache_writer_pid(void) {
+    return (u32)GetCurrentProcessId();
 }
 PID process_exec(
     Command cmd, b32 redirect_void, ReadPipe* opt_stdin,
     WritePipe* opt_stdout, WritePipe* opt_stderr, const char* opt_cwd
 ) {
+    trace_event_begin( "process_exec" );
+
     STARTUPINFOW        startup;
     PROCESS_INFORMATION info;
 
@@ -4930,9 +11520,11 @@ PID process_exec(
     expect( res, "failed to launch process '%s'!", cmd.args[0] );
 
     CloseHandle( info.hThread );
+    trace_event_end();
     return (isize)info.hProcess;
 }
 int process_wait( PID pid ) {
+    trace_event_begin( "process_wait" );
     DWORD res = WaitForSingleObject( (HANDLE)pid, INFINITE );
     switch( res ) {
         case WAIT_OBJECT_0: break;
@@ -4948,6 +11540,7 @@ int process_wait( PID pid ) {
         (HANDLE)pid, &exit_code ), "failed to get exit code!" );
 
     CloseHandle( (HANDLE)pid );
+    trace_event_end();
     return exit_code;
 }
 b32 process_wait_timed( PID pid, int* opt_out_res, u32 ms ) {
@@ -4993,7 +11586,7 @@ unsigned int win32_thread_proc( void* params ) {
 
 void thread_create( JobFN* func, void* params ) {
     expect(
-        global_thread_id_source < (CBUILD_THREAD_COUNT + 1),
+        global_thread_id_source < (CBUILD_THREAD_COUNT + CBUILD_SERVICE_THREAD_COUNT + 1),
         "exceeded maximum number of threads!" );
 
     u32 id = atomic_add( &global_thread_id_source, 1 );
@@ -5053,6 +11646,15 @@ char* internal_home(void) {
 #include <semaphore.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/uio.h>
+#include <poll.h>
+#if defined(PLATFORM_LINUX)
+    #include <sys/inotify.h>
+#endif
+#if defined(PLATFORM_MACOS)
+    #include <copyfile.h>
+#endif
+#include <sys/mman.h>
 #include <dirent.h>
 
 volatile atom global_semaphore_val = 0;
@@ -5069,7 +11671,7 @@ struct PosixThreadParams {
     void*  params;
     u32    id;
 };
-static struct PosixThreadParams global_posix_thread_params[CBUILD_THREAD_COUNT];
+static struct PosixThreadParams global_posix_thread_params[CBUILD_THREAD_COUNT + CBUILD_SERVICE_THREAD_COUNT];
 
 void _platform_init_(void) {
     return;
@@ -5095,13 +11697,7 @@ void* memory_alloc( usize size ) {
         return NULL;
     }
     memset( res, 0, size );
-    if( global_is_mt ) {
-        atomic_add64( &global_memory_usage, size );
-        atomic_add64( &global_total_memory_usage, size );
-    } else {
-        global_memory_usage       += size;
-        global_total_memory_usage += size;
-    }
+    memory_track_alloc( size );
     return res;
 }
 void* memory_realloc( void* memory, usize old_size, usize new_size ) {
@@ -5112,13 +11708,7 @@ void* memory_realloc( void* memory, usize old_size, usize new_size ) {
     }
     usize diff = new_size - old_size;
     memset( res + old_size, 0, diff );
-    if( global_is_mt ) {
-        atomic_add64( &global_memory_usage, diff );
-        atomic_add64( &global_total_memory_usage, diff );
-    } else {
-        global_memory_usage       += diff;
-        global_total_memory_usage += diff;
-    }
+    memory_track_alloc( diff );
     return res;
 }
 void memory_free( void* memory, usize size ) {
@@ -5127,13 +11717,7 @@ void memory_free( void* memory, usize size ) {
         return;
     }
     free( memory );
-    atom64 neg = size;
-    neg = -neg;
-    if( global_is_mt ) {
-        atomic_add64( &global_memory_usage, neg );
-    } else {
-        global_memory_usage += neg;
-    }
+    memory_track_free( size );
 }
 b32 path_is_absolute( const char* path ) {
     return *path == '/';
@@ -5239,6 +11823,71 @@ static b32 path_walk_dir_internal(
     closedir( dir );
     return true;
 }
+static b32 path_walk_dir_shallow(
+    DString* dir, b32 include_dirs,
+    usize* out_count, DString** out_buffer, Darray(DString*)* out_subdirs
+) {
+    struct dirent* entry;
+    DIR* d = opendir( dir );
+    if( !d ) {
+        return false;
+    }
+
+    while( (entry = readdir( d )) ) {
+        if(
+            strcmp( entry->d_name, "." )    == 0 ||
+            strcmp( entry->d_name, ".." )   == 0 ||
+            strcmp( entry->d_name, ".git" ) == 0
+        ) {
+            continue;
+        }
+
+        DString* full = dstring_fmt( "%s/%s", dir, entry->d_name );
+        if( !full ) {
+            closedir( d );
+            return false;
+        }
+
+        struct stat st;
+        stat( full, &st );
+
+        if( S_ISDIR( st.st_mode ) ) {
+            if( include_dirs ) {
+                DString* _new = dstring_append(
+                    *out_buffer, string_new( dstring_len( full ) + 1, full ) );
+                if( !_new ) {
+                    dstring_free( full );
+                    closedir( d );
+                    return false;
+                }
+                *out_buffer = _new;
+                *out_count += 1;
+            }
+
+            Darray(DString*) _subs = darray_push( *out_subdirs, &full );
+            if( !_subs ) {
+                dstring_free( full );
+                closedir( d );
+                return false;
+            }
+            *out_subdirs = _subs;
+            continue;
+        }
+
+        DString* _new = dstring_append(
+            *out_buffer, string_new( dstring_len( full ) + 1, full ) );
+        dstring_free( full );
+        if( !_new ) {
+            closedir( d );
+            return false;
+        }
+        *out_buffer = _new;
+        *out_count += 1;
+    }
+
+    closedir( d );
+    return true;
+}
 
 b32 fd_open( const char* path, FileOpenFlags flags, FD* out_file ) {
     if( !validate_file_flags( flags ) ) {
@@ -5288,6 +11937,56 @@ b32 fd_write( FD* file, usize size, const void* buf, usize* opt_out_write_size )
     }
     return true;
 }
+b32 fd_write_many( FD* file, usize count, const String* parts ) {
+    struct iovec vecs[64];
+
+    usize at  = 0; // current part.
+    usize off = 0; // bytes of current part already written.
+    for( ;; ) {
+        while( at < count && off >= parts[at].len ) {
+            at++;
+            off = 0;
+        }
+        if( at >= count ) {
+            return true;
+        }
+
+        usize batch = 0;
+        for( usize i = at; i < count; ++i ) {
+            if( batch >= static_array_len( vecs ) ) {
+                break;
+            }
+            usize skip = i == at ? off : 0;
+            if( parts[i].len <= skip ) {
+                continue;
+            }
+            vecs[batch].iov_base = (void*)(parts[i].cc + skip);
+            vecs[batch].iov_len  = parts[i].len - skip;
+            batch++;
+        }
+
+        isize written = writev( *file, vecs, batch );
+        if( written < 0 ) {
+            return false;
+        }
+        // consume written bytes, pipes may cut a batch short.
+        usize rem = written;
+        while( rem ) {
+            usize avail = parts[at].len - off;
+            if( rem < avail ) {
+                off += rem;
+                break;
+            }
+            rem -= avail;
+            at++;
+            off = 0;
+        }
+    }
+}
+static FD* logger_level_fd( LoggerLevel level ) {
+    static FD fds[2] = { STDOUT_FILENO, STDERR_FILENO };
+    return fds + (level >= LOGGER_LEVEL_ERROR);
+}
 b32 fd_read( FD* file, usize size, void* buf, usize* opt_out_read_size ) {
     isize read_size = read( *file, buf, size );
     if( read_size < 0 ) {
@@ -5327,6 +12026,44 @@ usize fd_query_position( FD* file ) {
     expect( pos >= 0, "failed to get current file position!" );
     return pos;
 }
+b32 fd_map( FD* file, FileMap* out_map ) {
+    assertion( file, "no file provided!" );
+    assertion( out_map, "no map provided!" );
+
+    memory_zero( out_map, sizeof(*out_map) );
+
+    usize size = fd_query_size( file );
+    if( !size ) {
+        // mapping a zero-length file is invalid,
+        // an empty view needs no mapping anyway.
+        return true;
+    }
+
+    void* view = mmap( NULL, size, PROT_READ, MAP_PRIVATE, *file, 0 );
+    if( view == MAP_FAILED ) {
+        return false;
+    }
+
+    out_map->view = string_new( size, (const char*)view );
+    return true;
+}
+b32 file_map( const char* path, FileMap* out_map ) {
+    FD file;
+    if( !fd_open( path, FOPEN_READ, &file ) ) {
+        return false;
+    }
+    b32 res = fd_map( &file, out_map );
+    fd_close( &file );
+    return res;
+}
+void file_unmap( FileMap* map ) {
+    if( map ) {
+        if( map->view.cc && map->view.len ) {
+            munmap( (void*)map->view.cc, map->view.len );
+        }
+        memory_zero( map, sizeof(*map) );
+    }
+}
 time_t file_query_time_create( const char* path ) {
     struct stat st;
     expect( stat( path, &st ) == 0,
@@ -5339,10 +12076,116 @@ time_t file_query_time_modify( const char* path ) {
         "failed to query modify time for '%s'!", path );
     return st.st_mtime;
 }
+static void file_stat_from_stat( const struct stat* st, FileStat* out_stat ) {
+    out_stat->exists      = true;
+    out_stat->time_modify = st->st_mtime;
+    out_stat->size        = (usize)st->st_size;
+}
+b32 file_stat( const char* path, FileStat* out_stat ) {
+    assertion( path && out_stat, "no path or out pointer provided!" );
+    memory_zero( out_stat, sizeof(*out_stat) );
+
+    struct stat st;
+    if( stat( path, &st ) != 0 ) {
+        return false;
+    }
+    file_stat_from_stat( &st, out_stat );
+    return true;
+}
+
+#define FILE_STAT_DIR_CACHE_CAP (8)
+struct FileStatDirCache {
+    // NOTE(alicia): views into the caller's paths, only valid for one batch.
+    String dirs[FILE_STAT_DIR_CACHE_CAP];
+    int    fds[FILE_STAT_DIR_CACHE_CAP];
+    usize  count;
+    usize  next;
+};
+static int file_stat_cache_dir( struct FileStatDirCache* cache, String dir ) {
+    for( usize i = 0; i < cache->count; ++i ) {
+        if( string_cmp( cache->dirs[i], dir ) ) {
+            return cache->fds[i];
+        }
+    }
+
+    const char* dir_c = local_fmt( "%.*s", (int)dir.len, dir.cc );
+    int fd = open( dir_c, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    if( fd < 0 ) {
+        return -1;
+    }
+
+    usize slot;
+    if( cache->count < FILE_STAT_DIR_CACHE_CAP ) {
+        slot = cache->count++;
+    } else {
+        slot        = cache->next;
+        cache->next = (cache->next + 1) % FILE_STAT_DIR_CACHE_CAP;
+        close( cache->fds[slot] );
+    }
+    cache->dirs[slot] = dir;
+    cache->fds[slot]  = fd;
+    return fd;
+}
+static void file_stat_many( usize count, const char** paths, FileStat* out_stats ) {
+    struct FileStatDirCache cache;
+    memory_zero( &cache, sizeof(cache) );
+
+    for( usize i = 0; i < count; ++i ) {
+        String path = string_from_cstr( paths[i] );
+        memory_zero( out_stats + i, sizeof(*out_stats) );
+
+        struct stat st;
+        usize sep = 0;
+        if( string_find_rev( path, '/', &sep ) && (sep + 1) < path.len ) {
+            String dir = path;
+            // NOTE(alicia): keep the separator for paths directly in root.
+            dir.len = sep ? sep : 1;
+
+            int fd = file_stat_cache_dir( &cache, dir );
+            if( fd >= 0 ) {
+                if( fstatat( fd, path.cc + sep + 1, &st, 0 ) == 0 ) {
+                    file_stat_from_stat( &st, out_stats + i );
+                }
+                continue;
+            }
+            // NOTE(alicia): directory itself couldn't be opened,
+            // fall through to a full-path stat.
+        }
+        if( stat( paths[i], &st ) == 0 ) {
+            file_stat_from_stat( &st, out_stats + i );
+        }
+    }
+
+    for( usize i = 0; i < cache.count; ++i ) {
+        close( cache.fds[i] );
+    }
+}
 b32 file_move( const char* dst, const char* src ) {
     return rename( src, dst ) == 0;
 }
+#if defined(PLATFORM_LINUX)
+#include <sys/syscall.h>
+// NOTE(alicia): _XOPEN_SOURCE hides the declaration in unistd.h .
+extern long syscall( long number, ... );
+static b32 file_copy_kernel( FD dst, FD src, usize size ) {
+    usize rem = size;
+    while( rem ) {
+        long copied = syscall(
+            SYS_copy_file_range, src, NULL, dst, NULL, rem, 0 );
+        if( copied <= 0 ) {
+            return false;
+        }
+        rem -= (usize)copied;
+    }
+    return true;
+}
+#endif
 b32 file_copy( const char* dst, const char* src ) {
+#if defined(PLATFORM_MACOS)
+    // clones on apfs, kernel copy otherwise.
+    return copyfile(
+        src, dst, NULL, COPYFILE_ALL | COPYFILE_CLONE | COPYFILE_UNLINK ) == 0;
+#else
     FD src_file, dst_file;
     if( !fd_open( src, FOPEN_READ, &src_file ) ) {
         return false;
@@ -5359,9 +12202,24 @@ b32 file_copy( const char* dst, const char* src ) {
         }
     }
 
-    char* buf = (char*)local_byte_buffer();
     usize rem = fd_query_size( &src_file );
 
+#if defined(PLATFORM_LINUX)
+    // copy entirely in the kernel, reflinking when the
+    // filesystem supports it.
+    if( file_copy_kernel( dst_file, src_file, rem ) ) {
+        fd_close( &src_file );
+        fd_close( &dst_file );
+        return true;
+    }
+    // kernel refused (e.g. special file or ancient kernel),
+    // rewind and fall back to a buffered copy.
+    lseek( src_file, 0, SEEK_SET );
+    lseek( dst_file, 0, SEEK_SET );
+#endif
+
+    char* buf = (char*)local_byte_buffer();
+
     while( rem ) {
         usize max_write = rem;
         if( rem > CBUILD_LOCAL_BUFFER_CAPACITY ) {
@@ -5385,6 +12243,7 @@ b32 file_copy( const char* dst, const char* src ) {
     fd_close( &src_file );
     fd_close( &dst_file );
     return true;
+#endif
 }
 b32 file_remove( const char* path ) {
     int res = remove( path );
@@ -5427,6 +12286,40 @@ void fence(void) {
 #endif
 }
 
+#if defined(PLATFORM_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+// NOTE(alicia): _XOPEN_SOURCE hides the declaration in unistd.h .
+extern long syscall( long number, ... );
+static void futex_wait( atom* address, atom expected, u32 ms ) {
+    struct timespec ts;
+    struct timespec* opt_ts = NULL;
+    if( ms != MT_WAIT_INFINITE ) {
+        ts.tv_sec  = ms / 1000;
+        ts.tv_nsec = (ms % 1000) * 1000000;
+        opt_ts     = &ts;
+    }
+    syscall(
+        SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, opt_ts, NULL, 0 );
+}
+static void futex_wake( atom* address, b32 all ) {
+    syscall(
+        SYS_futex, address, FUTEX_WAKE_PRIVATE,
+        all ? INT32_MAX : 1, NULL, NULL, 0 );
+}
+#else
+// NOTE(alicia): no portable futex outside of linux, poll instead.
+static void futex_wait( atom* address, atom expected, u32 ms ) {
+    unused( ms );
+    if( *address == expected ) {
+        thread_sleep( 1 );
+    }
+}
+static void futex_wake( atom* address, b32 all ) {
+    unused( address, all );
+}
+#endif
+
 b32 mutex_create( Mutex* out_mutex ) {
     struct PosixMutex* mtx = (struct PosixMutex*)out_mutex;
     mtx->value = 0;
@@ -5541,14 +12434,276 @@ void pipe_open( ReadPipe* out_read, WritePipe* out_write ) {
 void pipe_close( Pipe pipe ) {
     close( pipe );
 }
+static void pipe_capture_proc( void* params ) {
+    PipeCapture* capture = params;
 
-b32 process_in_path( const char* process_name ) {
-    Command cmd = command_new( "which", process_name );
+    Darray(PipeCaptureEntry) active =
+        darray_empty( sizeof(PipeCaptureEntry), 8 );
+    Darray(struct pollfd) fds = darray_empty( sizeof(struct pollfd), 8 );
+    expect( active && fds, "failed to allocate pipe capture state!" );
 
-    PID pid = process_exec( cmd, true, 0, 0, 0, 0 );
-    int res = process_wait( pid );
+    for( ;; ) {
+        mutex_lock( &capture->lock );
+        pipe_capture_collect( capture, &active );
+        mutex_unlock( &capture->lock );
 
-    return res == 0;
+        if( capture->shutdown && !darray_len( active ) ) {
+            break;
+        }
+
+        darray_clear( fds );
+        struct pollfd pfd;
+        memory_zero( &pfd, sizeof(pfd) );
+        pfd.fd     = capture->wake_read;
+        pfd.events = POLLIN;
+        expect( darray_try_push( fds, &pfd ), "fds out of sync!" );
+        for( usize i = 0; i < darray_len( active ); ++i ) {
+            pfd.fd = active[i].pipe;
+            Darray(struct pollfd) _new = darray_push( fds, &pfd );
+            expect( _new, "failed to grow pollfd list!" );
+            fds = _new;
+        }
+
+        int res = poll( fds, darray_len( fds ), -1 );
+        if( res < 0 ) {
+            continue; // interrupted by a signal.
+        }
+
+        if( fds[0].revents ) {
+            char discard[64];
+            isize discarded = read( capture->wake_read, discard, 64 );
+            unused( discarded );
+        }
+
+        for( usize i = darray_len( active ); i-- > 0; ) {
+            if( !fds[i + 1].revents ) {
+                continue;
+            }
+            PipeCaptureEntry* entry = active + i;
+            char* chunk = (char*)local_byte_buffer();
+            isize read_size =
+                read( entry->pipe, chunk, CBUILD_LOCAL_BUFFER_CAPACITY );
+            if( read_size > 0 ) {
+                DString* _new = dstring_append(
+                    entry->buf, string_new( read_size, chunk ) );
+                expect( _new, "failed to append captured output!" );
+                entry->buf = _new;
+                continue;
+            }
+            // EOF or error, pipe is done.
+            pipe_capture_finish( capture, active, i );
+        }
+    }
+
+    darray_free( fds );
+    darray_free( active );
+    atomic_add( &capture->stopped, 1 );
+}
+
+#if defined(PLATFORM_LINUX)
+struct WatchEntry {
+    int      wd;
+    DString* path;
+};
+static b32 path_watch_add(
+    int notify, Darray(struct WatchEntry)* watches, const char* path
+) {
+    int wd = inotify_add_watch(
+        notify, path,
+        IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+        IN_MOVED_TO | IN_MOVED_FROM );
+    if( wd < 0 ) {
+        cb_error( "path_watch: failed to watch '%s'!", path );
+        return false;
+    }
+    struct WatchEntry entry;
+    entry.wd   = wd;
+    entry.path = dstring_from_cstr( path );
+    if( !entry.path ) {
+        return false;
+    }
+    Darray(struct WatchEntry) _new = darray_push( *watches, &entry );
+    if( !_new ) {
+        dstring_free( entry.path );
+        return false;
+    }
+    *watches = _new;
+    return true;
+}
+static void path_watch_consume(
+    int notify, Darray(struct WatchEntry)* watches,
+    const char* buf, isize len, Darray(String)* changed
+) {
+    for( const char* at = buf; at < buf + len; ) {
+        const struct inotify_event* event = (const struct inotify_event*)at;
+        at += sizeof(*event) + event->len;
+        if( !event->len ) {
+            continue;
+        }
+
+        DString* dir = NULL;
+        for( usize i = 0; i < darray_len( *watches ); ++i ) {
+            if( (*watches)[i].wd == event->wd ) {
+                dir = (*watches)[i].path;
+                break;
+            }
+        }
+        if( !dir ) {
+            continue;
+        }
+
+        // full path lives in the caller's scratch scope.
+        String full =
+            string_from_cstr( local_fmt( "%s/%s", dir, event->name ) );
+
+        if( (event->mask & IN_ISDIR) && (event->mask & IN_CREATE) ) {
+            // subscribe to new directories as they appear.
+            path_watch_add( notify, watches, full.cc );
+        }
+
+        b32 seen = false;
+        for( usize i = 0; i < darray_len( *changed ); ++i ) {
+            if( string_cmp( (*changed)[i], full ) ) {
+                seen = true;
+                break;
+            }
+        }
+        if( !seen ) {
+            Darray(String) _new = darray_push( *changed, &full );
+            expect( _new, "failed to grow changed list!" );
+            *changed = _new;
+        }
+    }
+}
+b32 path_watch(
+    const char* dir, const WalkDirectory* wd,
+    WatchFN* callback, void* opt_params
+) {
+    assertion( dir && callback, "no directory or callback provided!" );
+
+    int notify = inotify_init();
+    if( notify < 0 ) {
+        cb_error( "path_watch: failed to initialize inotify!" );
+        return false;
+    }
+
+    Darray(struct WatchEntry) watches =
+        darray_empty( sizeof(struct WatchEntry), 32 );
+    b32 res = watches != NULL;
+
+    if( res ) {
+        res = path_watch_add( notify, &watches, dir );
+    }
+    for( usize i = 0; res && wd && i < wd->count; ++i ) {
+        if( path_is_directory( wd->paths[i].cc ) ) {
+            res = path_watch_add( notify, &watches, wd->paths[i].cc );
+        }
+    }
+
+    u64 raw[1024]; // aligned for struct inotify_event.
+    while( res ) {
+        isize len = read( notify, raw, sizeof(raw) );
+        if( len <= 0 ) {
+            continue; // interrupted by a signal.
+        }
+
+        ScratchScope scope = scratch_begin();
+        Darray(String) changed = darray_empty( sizeof(String), 8 );
+        expect( changed, "failed to allocate changed list!" );
+
+        path_watch_consume(
+            notify, &watches, (const char*)raw, len, &changed );
+
+        // settle window so bursts of writes arrive as one batch.
+        struct pollfd pfd;
+        memory_zero( &pfd, sizeof(pfd) );
+        pfd.fd     = notify;
+        pfd.events = POLLIN;
+        while( poll( &pfd, 1, 50 ) > 0 ) {
+            len = read( notify, raw, sizeof(raw) );
+            if( len <= 0 ) {
+                break;
+            }
+            path_watch_consume(
+                notify, &watches, (const char*)raw, len, &changed );
+        }
+
+        b32 keep = true;
+        if( darray_len( changed ) ) {
+            keep = callback( changed, opt_params );
+        }
+        darray_free( changed );
+        scratch_end( scope );
+
+        if( !keep ) {
+            break;
+        }
+    }
+
+    for( usize i = 0; i < darray_len( watches ); ++i ) {
+        dstring_free( watches[i].path );
+    }
+    darray_free( watches );
+    close( notify );
+    return res;
+}
+#else
+b32 path_watch(
+    const char* dir, const WalkDirectory* wd,
+    WatchFN* callback, void* opt_params
+) {
+    assertion( dir && callback, "no directory or callback provided!" );
+    // NOTE(alicia): no kernel notification API is wired up on this
+    // platform yet, poll time modified of the walked paths instead.
+    usize count = wd ? wd->count : 0;
+    Darray(time_t) times = darray_empty( sizeof(time_t), count ? count : 1 );
+    if( !times ) {
+        return false;
+    }
+    for( usize i = 0; i < count; ++i ) {
+        time_t time = file_query_time_modify( wd->paths[i].cc );
+        expect( darray_try_push( times, &time ), "miscalculated path count!" );
+    }
+
+    for( ;; ) {
+        thread_sleep( 200 );
+
+        ScratchScope scope = scratch_begin();
+        Darray(String) changed = darray_empty( sizeof(String), 8 );
+        expect( changed, "failed to allocate changed list!" );
+
+        for( usize i = 0; i < count; ++i ) {
+            time_t time = file_query_time_modify( wd->paths[i].cc );
+            if( time == times[i] ) {
+                continue;
+            }
+            times[i] = time;
+            Darray(String) _new = darray_push( changed, wd->paths + i );
+            expect( _new, "failed to grow changed list!" );
+            changed = _new;
+        }
+
+        b32 keep = true;
+        if( darray_len( changed ) ) {
+            keep = callback( changed, opt_params );
+        }
+        darray_free( changed );
+        scratch_end( scope );
+
+        if( !keep ) {
+            break;
+        }
+    }
+    darray_free( times );
+    return true;
+}
+#endif
+
+static b32 process_resolve_executable( const char* path ) {
+    return access( path, X_OK ) == 0;
+}
+static u32 compiler_cache_writer_pid(void) {
+    return (u32)getpid();
 }
 void posix_process_replace( Command cmd ) {
     execvp( cmd.args[0], (char* const*)cmd.args );
@@ -5557,6 +12712,8 @@ PID process_exec(
     Command cmd, b32 redirect_void, ReadPipe* opt_stdin,
     WritePipe* opt_stdout, WritePipe* opt_stderr, const char* opt_cwd
 ) {
+    trace_event_begin( "process_exec" );
+
     ReadPipe   stdin_;
     WritePipe stdout_;
     WritePipe stderr_;
@@ -5572,6 +12729,9 @@ PID process_exec(
         stderr_ = opt_stderr ? *opt_stderr : STDERR_FILENO;
     }
 
+    // resolve before forking, the resolver may allocate.
+    const char* resolved = process_resolve( cmd.args[0] );
+
     pid_t pid = fork();
     expect( pid >= 0, "failed to fork!" );
 
@@ -5584,6 +12744,7 @@ PID process_exec(
             cb_info( "%s", flat );
             dstring_free( flat );
         }
+        trace_event_end();
         return pid;
     }
 
@@ -5597,14 +12758,20 @@ PID process_exec(
         chdir( opt_cwd );
     }
 
+    if( resolved ) {
+        // skip execvp's PATH search, falls through on failure.
+        execv( resolved, (char* const*)(cmd.args) );
+    }
     expect_crash( execvp(
         cmd.args[0], (char* const*)(cmd.args) // cmd.args always has a null string at the end
     ) >= 0, "failed to execute command!" );
     exit(0);
 }
 int process_wait( PID pid ) {
+    trace_event_begin( "process_wait" );
     int wstatus = 0;
     expect( waitpid( pid, &wstatus, 0 ) == pid, "failed to wait for process!" );
+    trace_event_end();
 
     if( WIFEXITED( wstatus ) ) {
         int status = WEXITSTATUS( wstatus );
@@ -5685,8 +12852,9 @@ void* posix_thread_proc( void* params ) {
 
 void thread_create( JobFN* func, void* params ) {
     expect(
-        global_thread_id_source < (CBUILD_THREAD_COUNT + 1),
-        "exceeded maximum number of threads! max: %u", CBUILD_THREAD_COUNT );
+        global_thread_id_source < (CBUILD_THREAD_COUNT + CBUILD_SERVICE_THREAD_COUNT + 1),
+        "exceeded maximum number of threads! max: %u",
+        CBUILD_THREAD_COUNT + CBUILD_SERVICE_THREAD_COUNT );
 
     u32 id = atomic_add( &global_thread_id_source, 1 );
 